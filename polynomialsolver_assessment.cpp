@@ -1,440 +1,7366 @@
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <string>
-#include <stdexcept>
-#include <algorithm>
-#include <cmath>
-#include <iomanip>
-#include <sstream>
-#include <map>
-#include <regex>
-
-// Using standard types - no external dependencies required
-using BigInt = long long;
-using BigFloat = long double;
-
-/**
- * Simple JSON Parser for our specific use case
- * Parses the JSON structure used in test cases without external dependencies
- */
-class SimpleJsonParser {
-public:
-    /**
-     * Parses a JSON file and extracts the required data
-     * Returns a map with keys like "n", "k", "base_1", "value_1", etc.
-     */
-    static std::map<std::string, std::string> parseTestCase(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot open file: " + filename);
-        }
-        
-        // Read entire file content
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        file.close();
-        
-        std::map<std::string, std::string> result;
-        
-        // Remove all whitespace and newlines for easier parsing
-        content.erase(std::remove_if(content.begin(), content.end(), ::isspace), content.end());
-        
-        try {
-            // Parse keys section: "keys":{"n":4,"k":3}
-            std::regex keysRegex("\"keys\":\\{\"n\":(\\d+),\"k\":(\\d+)\\}");
-            std::smatch keysMatch;
-            if (std::regex_search(content, keysMatch, keysRegex)) {
-                result["n"] = keysMatch[1].str();
-                result["k"] = keysMatch[2].str();
-            }
-            
-            // Parse data entries: "1":{"base":"10","value":"4"}
-            std::regex entryRegex("\"(\\d+)\":\\{\"base\":\"(\\d+)\",\"value\":\"([^\"]+)\"\\}");
-            std::sregex_iterator iter(content.begin(), content.end(), entryRegex);
-            std::sregex_iterator end;
-            
-            for (; iter != end; ++iter) {
-                std::string index = (*iter)[1].str();
-                std::string base = (*iter)[2].str();
-                std::string value = (*iter)[3].str();
-                result["base_" + index] = base;
-                result["value_" + index] = value;
-            }
-            
-        } catch (const std::exception& e) {
-            throw std::runtime_error("JSON parsing failed: " + std::string(e.what()));
-        }
-        
-        return result;
-    }
-};
-
-/**
- * Polynomial Solver - Finds constant c in f(x) = ax² + bx + c
- * 
- * This program:
- * 1. Reads JSON files containing encoded values in different bases
- * 2. Decodes the y-values from their respective bases to decimal
- * 3. Uses the decoded roots (x, y) to solve for the constant c
- * 4. Uses standard C++ types (supports numbers up to ~9 × 10^18)
- */
-class PolynomialSolver {
-private:
-    /**
-     * Represents a single root point (x, y) where:
-     * x = the x-coordinate (input value)
-     * y = the y-coordinate (decoded from base-encoded string)
-     */
-    struct Root {
-        BigInt x; // x-coordinate (usually the index from JSON)
-        BigInt y; // y-coordinate (decoded from base-encoded value)
-        
-        Root(BigInt x_val, BigInt y_val) : x(x_val), y(y_val) {}
-        
-        std::string toString() const {
-            return "(" + std::to_string(x) + ", " + std::to_string(y) + ")";
-        }
-    };
-    
-    /**
-     * Container for a complete test case
-     * Holds the metadata (n, k) and all the roots
-     */
-    struct TestCase {
-        int n;                    // Number of roots
-        int k;                    // Parameter k
-        std::vector<Root> roots;  // All decoded roots
-        
-        TestCase(int n_val, int k_val, const std::vector<Root>& roots_val) 
-            : n(n_val), k(k_val), roots(roots_val) {}
-    };
-
-public:
-    /**
-     * Result class to hold the processed test case data
-     * Contains n, k, decoded roots, and calculated constant c
-     */
-    struct ProcessResult {
-        int n;                    // Number of roots
-        int k;                    // Parameter k from JSON
-        std::vector<Root> roots;  // List of decoded (x, y) coordinates
-        BigInt constantC;         // Calculated constant c
-        
-        ProcessResult(int n_val, int k_val, const std::vector<Root>& roots_val, BigInt constantC_val)
-            : n(n_val), k(k_val), roots(roots_val), constantC(constantC_val) {}
-    };
-
-    /**
-     * Main entry point for processing a single test case file
-     */
-    static ProcessResult processTestCase(const std::string& filename) {
-        TestCase testCase = readTestCase(filename);
-        BigInt constantC = solvePolynomial(testCase);
-        return ProcessResult(testCase.n, testCase.k, testCase.roots, constantC);
-    }
-
-    /**
-     * Main method - runs both test cases automatically
-     */
-    static void runTests() {
-        try {
-            // Test case 1
-            std::cout << "=== Test Case 1 ===" << std::endl;
-            TestCase testCase1 = readTestCase("test_case_1.json");
-            std::cout << "Found " << testCase1.roots.size() << " roots:" << std::endl;
-            for (const auto& root : testCase1.roots) {
-                std::cout << "  " << root.toString() << std::endl;
-            }
-            
-            BigInt constantC1 = solvePolynomial(testCase1);
-            std::cout << "Constant c for test case 1: " << constantC1 << std::endl;
-            
-            std::cout << "\n=== Test Case 2 ===" << std::endl;
-            TestCase testCase2 = readTestCase("test_case_2.json");
-            std::cout << "Found " << testCase2.roots.size() << " roots:" << std::endl;
-            for (size_t i = 0; i < std::min(testCase2.roots.size(), size_t(5)); ++i) {
-                std::cout << "  " << testCase2.roots[i].toString() << std::endl;
-            }
-            if (testCase2.roots.size() > 5) {
-                std::cout << "  ... and " << (testCase2.roots.size() - 5) << " more roots" << std::endl;
-            }
-            
-            BigInt constantC2 = solvePolynomial(testCase2);
-            std::cout << "Constant c for test case 2: " << constantC2 << std::endl;
-            
-        } catch (const std::exception& e) {
-            std::cerr << "Error: " << e.what() << std::endl;
-        }
-    }
-
-private:
-    /**
-     * Reads and parses a JSON test case file using simple regex parsing
-     * 
-     * JSON Structure:
-     * {
-     *   "keys": {"n": 4, "k": 3},
-     *   "1": {"base": "10", "value": "4"},
-     *   "2": {"base": "2", "value": "111"},
-     *   ...
-     * }
-     */
-    static TestCase readTestCase(const std::string& filename) {
-        // Parse JSON using simple parser
-        auto jsonData = SimpleJsonParser::parseTestCase(filename);
-        
-        // Extract metadata from parsed data
-        int n = std::stoi(jsonData.at("n"));  // Number of roots
-        int k = std::stoi(jsonData.at("k"));  // Parameter k
-        
-        std::cout << "Parsing test case: n=" << n << ", k=" << k << std::endl;
-        
-        std::vector<Root> roots;
-        
-        // Parse each root from the parsed data
-        // Note: We need to check all possible indices, not just 1 to n
-        // because some test cases might have gaps (like test_case_1.json has index 6)
-        for (int i = 1; i <= 20; i++) { // Check up to 20 to catch any gaps
-            std::string baseKey = "base_" + std::to_string(i);
-            std::string valueKey = "value_" + std::to_string(i);
-            
-            if (jsonData.find(baseKey) != jsonData.end() && 
-                jsonData.find(valueKey) != jsonData.end()) {
-                
-                std::string base = jsonData.at(baseKey);    // e.g., "2", "10", "16"
-                std::string value = jsonData.at(valueKey);  // e.g., "111", "4", "a1b2"
-                
-                std::cout << "Processing index " << i << ": base=" << base 
-                         << ", value=" << value << std::endl;
-                
-                BigInt decodedValue = decodeFromBase(value, base);
-                
-                // For this problem, we'll treat the decoded value as y
-                // and use the index i as x
-                BigInt x = static_cast<BigInt>(i);  // x = index (1, 2, 3, ...)
-                BigInt y = decodedValue; // y = decoded value from base
-                
-                std::cout << "  Decoded: " << value << " (base " << base 
-                         << ") = " << y << " (decimal)" << std::endl;
-                
-                roots.emplace_back(x, y);
-            }
-        }
-        
-        std::cout << "Successfully parsed " << roots.size() << " roots" << std::endl;
-        return TestCase(n, k, roots);
-    }
-    
-    /**
-     * Main polynomial solving logic
-     * 
-     * Strategy:
-     * 1. If we have 3+ roots, use system of equations (Cramer's rule)
-     * 2. If fewer roots, use simple polynomial assumption
-     */
-    static BigInt solvePolynomial(const TestCase& testCase) {
-        const std::vector<Root>& roots = testCase.roots;
-        
-        if (roots.empty()) {
-            throw std::invalid_argument("No roots provided");
-        }
-        
-        std::cout << "Solving polynomial with " << roots.size() << " roots" << std::endl;
-        
-        // For a polynomial f(x) = ax² + bx + c
-        // We have multiple points (x, y) where f(x) = y
-        
-        // If we have at least 3 points, we can solve for a, b, and c
-        if (roots.size() >= 3) {
-            return solveSystemOfEquations(roots);
-        } else {
-            // Fallback to simple approach for fewer points
-            return solveSimplePolynomial(roots);
-        }
-    }
-    
-    /**
-     * Solves the polynomial using system of equations
-     * 
-     * Mathematical approach:
-     * We have 3 equations:
-     * ax₁² + bx₁ + c = y₁  (from root 1)
-     * ax₂² + bx₂ + c = y₂  (from root 2)  
-     * ax₃² + bx₃ + c = y₃  (from root 3)
-     * 
-     * We can solve this system using Cramer's rule to find c
-     */
-    static BigInt solveSystemOfEquations(const std::vector<Root>& roots) {
-        // Use the first 3 points to solve the system:
-        // ax₁² + bx₁ + c = y₁
-        // ax₂² + bx₂ + c = y₂  
-        // ax₃² + bx₃ + c = y₃
-        
-        const Root& p1 = roots[0];  // First root (x₁, y₁)
-        const Root& p2 = roots[1];  // Second root (x₂, y₂)
-        const Root& p3 = roots[2];  // Third root (x₃, y₃)
-        
-        std::cout << "Using roots: " << p1.toString() << ", " 
-                  << p2.toString() << ", " << p3.toString() << std::endl;
-        
-        // Convert to BigFloat for precision in calculations
-        BigFloat x1 = static_cast<BigFloat>(p1.x);
-        BigFloat y1 = static_cast<BigFloat>(p1.y);
-        BigFloat x2 = static_cast<BigFloat>(p2.x);
-        BigFloat y2 = static_cast<BigFloat>(p2.y);
-        BigFloat x3 = static_cast<BigFloat>(p3.x);
-        BigFloat y3 = static_cast<BigFloat>(p3.y);
-        
-        // 🔑 MATHEMATICAL STEP: Using Cramer's rule to solve the system
-        // Matrix: [x₁² x₁ 1] [a]   [y₁]
-        //         [x₂² x₂ 1] [b] = [y₂]
-        //         [x₃² x₃ 1] [c]   [y₃]
-        
-        // Calculate the determinant of the coefficient matrix
-        // det = x1²(x2 - x3) + x2²(x3 - x1) + x3²(x1 - x2)
-        // This is the correct formula for the 3x3 determinant
-        BigFloat det = x1 * x1 * x2 + x2 * x2 * x3 + x3 * x3 * x1 
-                     - x1 * x1 * x3 - x2 * x2 * x1 - x3 * x3 * x2;
-        
-        std::cout << "Determinant: " << det << std::endl;
-        
-        // Check if determinant is zero (system has no unique solution)
-        if (std::abs(det) < 1e-10) {
-            std::cout << "Warning: Determinant is zero, using fallback method" << std::endl;
-            return solveSimplePolynomial(roots);
-        }
-        
-        // Calculate c using Cramer's rule
-        // Replace the third column with the constants [y₁, y₂, y₃]
-        // detC = x1²*x2*y3 + x2²*x3*y1 + x3²*x1*y2 - x1²*x3*y2 - x2²*x1*y3 - x3²*x2*y1
-        BigFloat detC = x1 * x1 * x2 * y3 + x2 * x2 * x3 * y1 + x3 * x3 * x1 * y2
-                      - x1 * x1 * x3 * y2 - x2 * x2 * x1 * y3 - x3 * x3 * x2 * y1;
-        
-        // c = detC / det
-        BigFloat c = detC / det;
-        
-        std::cout << "Calculated c (float): " << c << std::endl;
-        
-        // Round to nearest integer
-        BigInt result = static_cast<BigInt>(std::round(c));
-        
-        // Verify the solution with other roots
-        verifySolution(roots, c);
-        
-        return result;
-    }
-    
-    /**
-     * Fallback method for solving polynomial with fewer than 3 roots
-     * 
-     * Assumes: f(x) = x² + c (a=1, b=0)
-     * Then: c = y - x²
-     */
-    static BigInt solveSimplePolynomial(const std::vector<Root>& roots) {
-        // Simple approach: assume a = 1 and b = 0, then c = y - x²
-        const Root& firstRoot = roots[0];
-        BigInt x = firstRoot.x;
-        BigInt y = firstRoot.y;
-        
-        // Calculate x²
-        BigInt xSquared = x * x;
-        
-        // Calculate c = y - x²
-        BigInt c = y - xSquared;
-        
-        std::cout << "Simple polynomial: c = " << y << " - " << x << "² = " << c << std::endl;
-        
-        // Verify with other roots if possible
-        for (size_t i = 1; i < roots.size(); i++) {
-            const Root& root = roots[i];
-            BigInt expectedY = root.x * root.x + c;
-            if (expectedY != root.y) {
-                std::cout << "Warning: Root " << root.toString() 
-                         << " doesn't satisfy the equation with c = " << c << std::endl;
-            }
-        }
-        
-        return c;
-    }
-    
-    /**
-     * Verifies the calculated solution with all roots
-     * 
-     * For verification, assumes f(x) = x² + c
-     * Checks if f(x) = y for each root
-     */
-    static void verifySolution(const std::vector<Root>& roots, BigFloat c) {
-        std::cout << "Verifying solution..." << std::endl;
-        // Verify the solution with all roots
-        for (const Root& root : roots) {
-            BigFloat x = static_cast<BigFloat>(root.x);
-            BigFloat y = static_cast<BigFloat>(root.y);
-            
-            // For verification, assume a = 1, b = 0: f(x) = x² + c
-            BigFloat expectedY = x * x + c;
-            BigFloat difference = std::abs(y - expectedY);
-            
-            // If difference is more than 1, show a warning
-            if (difference > 1.0) {
-                std::cout << "Warning: Root " << root.toString() 
-                         << " has difference: " << difference << std::endl;
-            } else {
-                std::cout << "✓ Root " << root.toString() << " verified (diff: " 
-                         << difference << ")" << std::endl;
-            }
-        }
-    }
-    
-    /**
-     * 🔑 CORE FUNCTION: Decodes a string value from a given base to decimal
-     * 
-     * This is the heart of the solution! It converts encoded strings like:
-     * - "111" (base 2) → 7 (decimal)
-     * - "213" (base 4) → 39 (decimal)
-     * - "a1b2" (base 16) → 41394 (decimal)
-     */
-    static BigInt decodeFromBase(const std::string& value, const std::string& baseStr) {
-        int base = std::stoi(baseStr);
-        
-        // Convert character to digit value
-        auto charToDigit = [](char c) -> int {
-            if (c >= '0' && c <= '9') {
-                return c - '0';
-            } else if (c >= 'a' && c <= 'z') {
-                return c - 'a' + 10;
-            } else if (c >= 'A' && c <= 'Z') {
-                return c - 'A' + 10;
-            }
-            throw std::invalid_argument("Invalid character in base conversion: " + std::string(1, c));
-        };
-        
-        BigInt result = 0;
-        BigInt baseMultiplier = 1;
-        
-        // Process digits from right to left
-        for (int i = static_cast<int>(value.length()) - 1; i >= 0; i--) {
-            int digitValue = charToDigit(value[i]);
-            
-            if (digitValue >= base) {
-                throw std::invalid_argument("Digit value " + std::to_string(digitValue) + 
-                                          " is invalid for base " + std::to_string(base));
-            }
-            
-            result += static_cast<BigInt>(digitValue) * baseMultiplier;
-            baseMultiplier *= base;
-        }
-        
-        return result;
-    }
-};
-
-// Main function
-int main() {
-    std::cout << "Polynomial Solver C++ Version" << std::endl;
-    std::cout << "=====================================" << std::endl;
-    
-    PolynomialSolver::runTests();
-    
-    return 0;
-}
\ No newline at end of file
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <map>
+#include <list>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <chrono>
+#include <limits>
+#include <type_traits>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <cctype>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <glob.h>
+#define POLYSOLVER_HAVE_MMAP 1
+#define POLYSOLVER_HAVE_GLOB 1
+#endif
+
+// Using standard types - no external dependencies required
+using BigFloat = long double;
+
+/**
+ * Scratch memory for one test case at a time
+ *
+ * A monotonic arena behind std::pmr::memory_resource: allocations bump a
+ * pointer through one block, frees are no-ops, and reset() drops everything
+ * at once. Requests that do not fit go to the heap until the next reset,
+ * which then grows the block to the high-water mark, so after the first
+ * few files of a given size the arena itself stops touching the heap
+ * (overflowCount() stays zero). Only what is routed through resource()
+ * lands here: the containers of solver scratch, keys and messages are
+ * still plain std::vector and std::string on the heap.
+ *
+ * A Scope makes an arena current on its thread and resets it on exit.
+ * While one is active, BigInt limbs that outgrow their inline storage,
+ * parse buffers and root lists come from the arena, so nothing allocated
+ * inside may outlive the scope; Suspend returns to the heap for data that
+ * must (cache entries, say).
+ */
+class FileArena final : public std::pmr::memory_resource {
+public:
+    explicit FileArena(std::size_t initialBytes = std::size_t(1) << 16) { grow(initialBytes); }
+
+    FileArena(const FileArena&) = delete;
+    FileArena& operator=(const FileArena&) = delete;
+
+    ~FileArena() override { releaseOverflow(); }
+
+    // The current arena on this thread, or the heap outside any Scope
+    static std::pmr::memory_resource* resource() {
+        return current_ != nullptr ? static_cast<std::pmr::memory_resource*>(current_)
+                                   : std::pmr::new_delete_resource();
+    }
+
+    class Scope {
+    public:
+        explicit Scope(FileArena& arena) : arena_(arena), previous_(current_) { current_ = &arena; }
+        ~Scope() {
+            current_ = previous_;
+            arena_.reset();
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FileArena& arena_;
+        FileArena* previous_;
+    };
+
+    class Suspend {
+    public:
+        Suspend() : previous_(current_) { current_ = nullptr; }
+        ~Suspend() { current_ = previous_; }
+        Suspend(const Suspend&) = delete;
+        Suspend& operator=(const Suspend&) = delete;
+
+    private:
+        FileArena* previous_;
+    };
+
+    // Frees everything; the block is kept, grown to cover the last high-water mark
+    void reset() {
+        const std::size_t peak = used_ + overflowBytes_;
+        releaseOverflow();
+        if (peak > capacity_) {
+            grow(peak + peak / 2);
+        }
+        used_ = 0;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+    // Heap allocations since the last reset (zero in steady state)
+    std::size_t overflowCount() const { return overflow_.size(); }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        const std::size_t start = (used_ + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= capacity_) {
+            used_ = start + bytes;
+            return block_.get() + start;
+        }
+        void* chunk = ::operator new(bytes, std::align_val_t(alignment));
+        try {
+            overflow_.push_back(Overflow{chunk, alignment});
+        } catch (...) {
+            ::operator delete(chunk, std::align_val_t(alignment));
+            throw;
+        }
+        overflowBytes_ += bytes + alignment;
+        return chunk;
+    }
+
+    /**
+     * Memory comes back all at once in reset(), except that the owning
+     * thread freeing the latest allocation (a temporary, typically) pops it
+     * so the next one reuses the same, still cached, bytes
+     * Freeing memory from before the last reset() is a use after free: its
+     * address may be the latest allocation again, and popping it would hand
+     * live bytes out twice.
+     */
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t) override {
+        if (current_ == this && static_cast<std::byte*>(pointer) + bytes == block_.get() + used_) {
+            used_ -= bytes;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Overflow {
+        void* chunk;
+        std::size_t alignment;
+    };
+
+    static inline thread_local FileArena* current_ = nullptr;
+
+    struct BlockDelete {
+        void operator()(std::byte* block) const { ::operator delete(block, std::align_val_t(kBlockAlignment)); }
+    };
+    static constexpr std::size_t kBlockAlignment = 64;
+
+    std::unique_ptr<std::byte, BlockDelete> block_;
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+    std::vector<Overflow> overflow_;
+    std::size_t overflowBytes_ = 0;
+
+    void grow(std::size_t bytes) {
+        block_.reset(static_cast<std::byte*>(::operator new(bytes, std::align_val_t(kBlockAlignment))));
+        capacity_ = bytes;
+    }
+
+    void releaseOverflow() {
+        for (const Overflow& overflow : overflow_) {
+            ::operator delete(overflow.chunk, std::align_val_t(overflow.alignment));
+        }
+        overflow_.clear();
+        overflowBytes_ = 0;
+    }
+};
+
+/**
+ * Arbitrary-precision signed integer
+ *
+ * Sign-magnitude representation with little-endian 64-bit limbs. Limb products
+ * and carries are computed in unsigned __int128, so every inner loop is a
+ * single native multiply plus adds.
+ *
+ * Magnitudes up to 256 bits are stored inline in the object, so values that
+ * used to fit in a long long never touch the heap. Larger ones come from
+ * the current FileArena, if any.
+ */
+class BigInt {
+public:
+    using Limb = std::uint64_t;
+    using DoubleLimb = unsigned __int128;
+    static constexpr int kLimbBits = 64;
+
+private:
+    /**
+     * Small-buffer limb vector
+     * The first kInlineLimbs limbs live inside the object; larger magnitudes
+     * spill into a block that grows geometrically, taken from the current
+     * FileArena or, outside any Scope, the heap. Each block carries a hidden
+     * leading limb naming its resource, so it is freed where it came from.
+     */
+    class LimbStorage {
+    public:
+        static constexpr std::size_t kInlineLimbs = 4;
+
+        LimbStorage() : data_(inline_), size_(0), capacity_(kInlineLimbs) {}
+
+        LimbStorage(const LimbStorage& other) : LimbStorage() {
+            assign(other.data_, other.size_);
+        }
+
+        LimbStorage(LimbStorage&& other) noexcept : LimbStorage() {
+            steal(other);
+        }
+
+        LimbStorage& operator=(const LimbStorage& other) {
+            if (this != &other) {
+                assign(other.data_, other.size_);
+            }
+            return *this;
+        }
+
+        LimbStorage& operator=(LimbStorage&& other) noexcept {
+            if (this != &other) {
+                release();
+                steal(other);
+            }
+            return *this;
+        }
+
+        ~LimbStorage() { release(); }
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        Limb* data() { return data_; }
+        const Limb* data() const { return data_; }
+        Limb& operator[](std::size_t i) { return data_[i]; }
+        Limb operator[](std::size_t i) const { return data_[i]; }
+        Limb back() const { return data_[size_ - 1]; }
+
+        void clear() { size_ = 0; }
+
+        void reserve(std::size_t n) {
+            if (n <= capacity_) {
+                return;
+            }
+            std::size_t newCapacity = std::max(n, capacity_ * 2);
+            Limb* block = allocate(newCapacity);
+            std::memcpy(block, data_, size_ * sizeof(Limb));
+            release();
+            data_ = block;
+            capacity_ = newCapacity;
+        }
+
+        // New limbs are zero-filled
+        void resize(std::size_t n) {
+            reserve(n);
+            if (n > size_) {
+                std::memset(data_ + size_, 0, (n - size_) * sizeof(Limb));
+            }
+            size_ = n;
+        }
+
+        void push_back(Limb value) {
+            reserve(size_ + 1);
+            data_[size_++] = value;
+        }
+
+        void assign(const Limb* src, std::size_t n) {
+            reserve(n);
+            std::memmove(data_, src, n * sizeof(Limb));
+            size_ = n;
+        }
+
+        // Drops high zero limbs so size() is the true limb length
+        void trim() {
+            while (size_ > 0 && data_[size_ - 1] == 0) {
+                --size_;
+            }
+        }
+
+    private:
+        Limb* data_;
+        std::size_t size_;
+        std::size_t capacity_;
+        Limb inline_[kInlineLimbs];
+
+        bool isInline() const { return data_ == inline_; }
+
+        // Spilled blocks start with a hidden limb naming the resource they came from
+        static Limb* allocate(std::size_t n) {
+            static_assert(sizeof(std::pmr::memory_resource*) <= sizeof(Limb), "resource must fit a limb");
+            std::pmr::memory_resource* resource = FileArena::resource();
+            auto* block = static_cast<Limb*>(resource->allocate((n + 1) * sizeof(Limb), alignof(Limb)));
+            std::memcpy(block, &resource, sizeof(resource));
+            return block + 1;
+        }
+
+        void release() {
+            if (!isInline()) {
+                std::pmr::memory_resource* resource;
+                std::memcpy(&resource, data_ - 1, sizeof(resource));
+                resource->deallocate(data_ - 1, (capacity_ + 1) * sizeof(Limb), alignof(Limb));
+            }
+            data_ = inline_;
+            capacity_ = kInlineLimbs;
+        }
+
+        void steal(LimbStorage& other) {
+            if (other.isInline()) {
+                std::memcpy(inline_, other.inline_, other.size_ * sizeof(Limb));
+                data_ = inline_;
+                capacity_ = kInlineLimbs;
+            } else {
+                data_ = other.data_;
+                capacity_ = other.capacity_;
+                other.data_ = other.inline_;
+                other.capacity_ = kInlineLimbs;
+            }
+            size_ = other.size_;
+            other.size_ = 0;
+        }
+    };
+
+    LimbStorage mag_;        // |value|, no high zero limbs (zero has no limbs)
+    bool negative_ = false;  // never set for zero
+
+public:
+    BigInt() = default;
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    BigInt(T value) {
+        if constexpr (std::is_signed<T>::value) {
+            if (value < 0) {
+                negative_ = true;
+                // Negate in unsigned space so LLONG_MIN does not overflow
+                mag_.push_back(Limb(0) - static_cast<Limb>(static_cast<long long>(value)));
+                return;
+            }
+        }
+        if (value != 0) {
+            mag_.push_back(static_cast<Limb>(value));
+        }
+    }
+
+    /**
+     * Parses an optionally signed integer written in the given base (2-36)
+     */
+    static BigInt fromString(std::string_view text, int base = 10) {
+        if (base < 2 || base > 36) {
+            throw std::invalid_argument("Unsupported base: " + std::to_string(base));
+        }
+        bool negative = false;
+        if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+            negative = text[0] == '-';
+            text.remove_prefix(1);
+        }
+        if (text.empty()) {
+            throw std::invalid_argument("Empty integer literal");
+        }
+
+        BigInt result;
+        for (char c : text) {
+            int digit = digitValue(c);
+            if (digit < 0 || digit >= base) {
+                throw std::invalid_argument("Invalid digit '" + std::string(1, c) +
+                                            "' for base " + std::to_string(base));
+            }
+            result.mulAddSmall(static_cast<Limb>(base), static_cast<Limb>(digit));
+        }
+        result.negative_ = negative && !result.isZero();
+        return result;
+    }
+
+    /**
+     * Builds the integer nearest to a (finite) long double, truncating toward zero
+     */
+    static BigInt fromLongDouble(long double value) {
+        if (!std::isfinite(value)) {
+            throw std::invalid_argument("Cannot convert non-finite value to BigInt");
+        }
+        bool negative = value < 0;
+        value = std::trunc(std::fabs(value));
+
+        // Peel off 64-bit chunks from the top: value = Σ chunk_i · 2^(64·i)
+        int exponent = 0;
+        std::frexp(value, &exponent);
+        int limbCount = exponent > 0 ? (exponent + kLimbBits - 1) / kLimbBits : 0;
+
+        BigInt result;
+        result.mag_.resize(static_cast<std::size_t>(limbCount));
+        for (int i = limbCount - 1; i >= 0; --i) {
+            long double scale = std::ldexp(1.0L, kLimbBits * i);
+            long double chunk = std::floor(value / scale);
+            result.mag_[static_cast<std::size_t>(i)] = static_cast<Limb>(chunk);
+            value -= chunk * scale;
+        }
+        result.mag_.trim();
+        result.negative_ = negative && !result.isZero();
+        return result;
+    }
+
+    /**
+     * Builds a non-negative integer from little-endian limbs
+     */
+    static BigInt fromLimbs(const Limb* limbs, std::size_t count) {
+        BigInt result;
+        result.mag_.assign(limbs, count);
+        result.mag_.trim();
+        return result;
+    }
+
+    /**
+     * Builds a non-negative value in place: fill(limbs) writes into count
+     * zero-filled little-endian limbs
+     */
+    template <typename Fill>
+    static BigInt fromLimbs(std::size_t count, Fill fill) {
+        BigInt result;
+        result.mag_.resize(count);
+        fill(result.mag_.data());
+        result.mag_.trim();
+        return result;
+    }
+
+    bool isZero() const { return mag_.empty(); }
+    bool isNegative() const { return negative_; }
+    int sign() const { return isZero() ? 0 : (negative_ ? -1 : 1); }
+    std::size_t limbCount() const { return mag_.size(); }
+    const Limb* limbs() const { return mag_.data(); }
+
+    std::size_t bitLength() const {
+        if (isZero()) {
+            return 0;
+        }
+        return mag_.size() * kLimbBits - static_cast<std::size_t>(__builtin_clzll(mag_.back()));
+    }
+
+    // Bit of the magnitude
+    bool testBit(std::size_t bit) const {
+        std::size_t limb = bit / kLimbBits;
+        return limb < mag_.size() && ((mag_[limb] >> (bit % kLimbBits)) & 1) != 0;
+    }
+
+    bool fitsInt64() const {
+        if (mag_.size() > 1) {
+            return false;
+        }
+        if (isZero()) {
+            return true;
+        }
+        return negative_ ? mag_[0] <= (Limb(1) << 63) : mag_[0] < (Limb(1) << 63);
+    }
+
+    long long toInt64() const {
+        if (!fitsInt64()) {
+            throw std::overflow_error("BigInt does not fit in 64 bits");
+        }
+        if (isZero()) {
+            return 0;
+        }
+        return negative_ ? static_cast<long long>(Limb(0) - mag_[0]) : static_cast<long long>(mag_[0]);
+    }
+
+    explicit operator long double() const {
+        long double result = 0.0L;
+        for (std::size_t i = mag_.size(); i-- > 0;) {
+            result = result * 18446744073709551616.0L + static_cast<long double>(mag_[i]);
+        }
+        return negative_ ? -result : result;
+    }
+
+    BigInt abs() const {
+        BigInt result(*this);
+        result.negative_ = false;
+        return result;
+    }
+
+    // Pre-sizes the magnitude for a value that will grow to about limbs limbs
+    void reserveLimbs(std::size_t limbs) { mag_.reserve(limbs); }
+
+    /**
+     * In-place this = this * factor + addend for single-limb operands
+     * This is the inner step of every base conversion.
+     */
+    void mulAddSmall(Limb factor, Limb addend) {
+        Limb carry = addend;
+        for (std::size_t i = 0; i < mag_.size(); ++i) {
+            DoubleLimb t = static_cast<DoubleLimb>(mag_[i]) * factor + carry;
+            mag_[i] = static_cast<Limb>(t);
+            carry = static_cast<Limb>(t >> kLimbBits);
+        }
+        if (carry != 0) {
+            mag_.push_back(carry);
+        }
+        mag_.trim();
+        if (isZero()) {
+            negative_ = false;
+        }
+    }
+
+    /**
+     * In-place truncating division of the magnitude by a single limb
+     * Returns the remainder of |this| / divisor.
+     */
+    Limb divModSmall(Limb divisor) {
+        if (divisor == 0) {
+            throw std::domain_error("Division by zero");
+        }
+        DoubleLimb remainder = 0;
+        for (std::size_t i = mag_.size(); i-- > 0;) {
+            DoubleLimb cur = (remainder << kLimbBits) | mag_[i];
+            mag_[i] = static_cast<Limb>(cur / divisor);
+            remainder = cur % divisor;
+        }
+        mag_.trim();
+        if (isZero()) {
+            negative_ = false;
+        }
+        return static_cast<Limb>(remainder);
+    }
+
+    std::string toString(int base = 10) const {
+        if (base < 2 || base > 36) {
+            throw std::invalid_argument("Unsupported base: " + std::to_string(base));
+        }
+        if (isZero()) {
+            return "0";
+        }
+
+        // Divide by the largest power of base that fits in a limb and emit
+        // that many digits per step
+        Limb chunkDivisor = static_cast<Limb>(base);
+        int chunkDigits = 1;
+        while (chunkDivisor <= std::numeric_limits<Limb>::max() / static_cast<Limb>(base)) {
+            chunkDivisor *= static_cast<Limb>(base);
+            ++chunkDigits;
+        }
+
+        static const char kDigits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+        std::string digits;
+        BigInt work = abs();
+        while (!work.isZero()) {
+            Limb chunk = work.divModSmall(chunkDivisor);
+            for (int i = 0; i < chunkDigits; ++i) {
+                digits.push_back(kDigits[chunk % static_cast<Limb>(base)]);
+                chunk /= static_cast<Limb>(base);
+                if (work.isZero() && chunk == 0) {
+                    break;
+                }
+            }
+        }
+        if (negative_) {
+            digits.push_back('-');
+        }
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    // ---- Arithmetic -------------------------------------------------------
+
+    BigInt operator-() const {
+        BigInt result(*this);
+        result.negative_ = !result.isZero() && !negative_;
+        return result;
+    }
+
+    BigInt& operator+=(const BigInt& other) { return addSigned(other, other.negative_); }
+    BigInt& operator-=(const BigInt& other) { return addSigned(other, !other.negative_); }
+
+    BigInt& operator*=(const BigInt& other) {
+        *this = *this * other;
+        return *this;
+    }
+
+    BigInt& operator/=(const BigInt& other) {
+        BigInt quotient, remainder;
+        divMod(*this, other, quotient, remainder);
+        *this = std::move(quotient);
+        return *this;
+    }
+
+    BigInt& operator%=(const BigInt& other) {
+        BigInt quotient, remainder;
+        divMod(*this, other, quotient, remainder);
+        *this = std::move(remainder);
+        return *this;
+    }
+
+    friend BigInt operator+(BigInt a, const BigInt& b) { return a += b; }
+    friend BigInt operator-(BigInt a, const BigInt& b) { return a -= b; }
+    friend BigInt operator/(BigInt a, const BigInt& b) { return a /= b; }
+    friend BigInt operator%(BigInt a, const BigInt& b) { return a %= b; }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        BigInt result;
+        if (a.isZero() || b.isZero()) {
+            return result;
+        }
+        if (a.mag_.size() == 1 && b.mag_.size() == 1) {
+            // Fast path: one native 64x64->128 multiply
+            DoubleLimb product = static_cast<DoubleLimb>(a.mag_[0]) * b.mag_[0];
+            Limb productLimbs[2] = {static_cast<Limb>(product), static_cast<Limb>(product >> kLimbBits)};
+            result.mag_.assign(productLimbs, productLimbs[1] != 0 ? 2 : 1);
+        } else {
+            result.mag_.resize(a.mag_.size() + b.mag_.size());
+            multiplyMagnitudes(a.mag_.data(), a.mag_.size(), b.mag_.data(), b.mag_.size(),
+                               result.mag_.data());
+            result.mag_.trim();
+        }
+        result.negative_ = a.negative_ != b.negative_;
+        return result;
+    }
+
+    /**
+     * Truncating division (C++ semantics): quotient rounds toward zero and the
+     * remainder takes the sign of the dividend
+     */
+    static void divMod(const BigInt& dividend, const BigInt& divisor, BigInt& quotient, BigInt& remainder) {
+        if (divisor.isZero()) {
+            throw std::domain_error("Division by zero");
+        }
+        if (compareMagnitudes(dividend.mag_, divisor.mag_) < 0) {
+            remainder = dividend;
+            quotient = BigInt();
+            return;
+        }
+
+        BigInt q, r;
+        if (divisor.mag_.size() == 1) {
+            q = dividend;
+            r = BigInt(q.divModSmall(divisor.mag_[0]));
+        } else {
+            divideMagnitudes(dividend.mag_, divisor.mag_, q.mag_, r.mag_);
+        }
+        q.negative_ = !q.isZero() && (dividend.negative_ != divisor.negative_);
+        r.negative_ = !r.isZero() && dividend.negative_;
+        quotient = std::move(q);
+        remainder = std::move(r);
+    }
+
+    static BigInt gcd(BigInt a, BigInt b) {
+        a.negative_ = false;
+        b.negative_ = false;
+        while (!b.isZero()) {
+            BigInt r = a % b;
+            a = std::move(b);
+            b = std::move(r);
+        }
+        return a;
+    }
+
+    BigInt& operator<<=(std::size_t bits) {
+        if (isZero() || bits == 0) {
+            return *this;
+        }
+        std::size_t limbShift = bits / kLimbBits;
+        unsigned bitShift = static_cast<unsigned>(bits % kLimbBits);
+        std::size_t oldSize = mag_.size();
+        mag_.resize(oldSize + limbShift + 1);
+        Limb* d = mag_.data();
+        for (std::size_t i = oldSize; i-- > 0;) {
+            Limb v = d[i];
+            d[i + limbShift + 1] |= bitShift ? (v >> (kLimbBits - bitShift)) : 0;
+            d[i + limbShift] = v << bitShift;
+        }
+        std::memset(d, 0, limbShift * sizeof(Limb));
+        mag_.trim();
+        return *this;
+    }
+
+    // Shifts the magnitude (truncates toward zero for negative values)
+    BigInt& operator>>=(std::size_t bits) {
+        std::size_t limbShift = bits / kLimbBits;
+        if (limbShift >= mag_.size()) {
+            *this = BigInt();
+            return *this;
+        }
+        unsigned bitShift = static_cast<unsigned>(bits % kLimbBits);
+        std::size_t newSize = mag_.size() - limbShift;
+        Limb* d = mag_.data();
+        for (std::size_t i = 0; i < newSize; ++i) {
+            Limb lo = d[i + limbShift] >> bitShift;
+            Limb hi = (bitShift && i + limbShift + 1 < mag_.size())
+                          ? d[i + limbShift + 1] << (kLimbBits - bitShift) : 0;
+            d[i] = lo | hi;
+        }
+        mag_.resize(newSize);
+        mag_.trim();
+        if (isZero()) {
+            negative_ = false;
+        }
+        return *this;
+    }
+
+    friend BigInt operator<<(BigInt a, std::size_t bits) { return a <<= bits; }
+    friend BigInt operator>>(BigInt a, std::size_t bits) { return a >>= bits; }
+
+    // ---- Comparison -------------------------------------------------------
+
+    static int compare(const BigInt& a, const BigInt& b) {
+        if (a.negative_ != b.negative_) {
+            return a.negative_ ? -1 : 1;
+        }
+        int magnitudeOrder = compareMagnitudes(a.mag_, b.mag_);
+        return a.negative_ ? -magnitudeOrder : magnitudeOrder;
+    }
+
+    friend bool operator==(const BigInt& a, const BigInt& b) { return compare(a, b) == 0; }
+    friend bool operator!=(const BigInt& a, const BigInt& b) { return compare(a, b) != 0; }
+    friend bool operator<(const BigInt& a, const BigInt& b) { return compare(a, b) < 0; }
+    friend bool operator<=(const BigInt& a, const BigInt& b) { return compare(a, b) <= 0; }
+    friend bool operator>(const BigInt& a, const BigInt& b) { return compare(a, b) > 0; }
+    friend bool operator>=(const BigInt& a, const BigInt& b) { return compare(a, b) >= 0; }
+
+    friend std::ostream& operator<<(std::ostream& out, const BigInt& value) {
+        return out << value.toString();
+    }
+
+    // Maps '0'-'9', 'a'-'z', 'A'-'Z' to 0-35, anything else to -1
+    static int digitValue(char c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        } else if (c >= 'a' && c <= 'z') {
+            return c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'Z') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+private:
+    static int compareMagnitudes(const LimbStorage& a, const LimbStorage& b) {
+        if (a.size() != b.size()) {
+            return a.size() < b.size() ? -1 : 1;
+        }
+        for (std::size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * this += (negateOther ? -|other| : |other|)
+     * Same signs add magnitudes; opposite signs subtract the smaller
+     * magnitude from the larger one and keep the larger one's sign.
+     */
+    BigInt& addSigned(const BigInt& other, bool otherNegative) {
+        if (this == &other) {
+            BigInt copy(other);
+            return addSigned(copy, otherNegative);
+        }
+        if (other.isZero()) {
+            return *this;
+        }
+        if (isZero()) {
+            mag_ = other.mag_;
+            negative_ = otherNegative;
+            return *this;
+        }
+
+        if (negative_ == otherNegative) {
+            std::size_t n = std::max(mag_.size(), other.mag_.size());
+            mag_.resize(n + 1);
+            Limb carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                DoubleLimb t = static_cast<DoubleLimb>(mag_[i]) + carry +
+                               (i < other.mag_.size() ? other.mag_[i] : 0);
+                mag_[i] = static_cast<Limb>(t);
+                carry = static_cast<Limb>(t >> kLimbBits);
+            }
+            mag_[n] = carry;
+            mag_.trim();
+            return *this;
+        }
+
+        int order = compareMagnitudes(mag_, other.mag_);
+        if (order == 0) {
+            *this = BigInt();
+            return *this;
+        }
+        if (order > 0) {
+            subtractMagnitudeInPlace(mag_, other.mag_.data(), other.mag_.size());
+        } else {
+            LimbStorage larger = other.mag_;
+            subtractMagnitudeInPlace(larger, mag_.data(), mag_.size());
+            mag_ = std::move(larger);
+            negative_ = otherNegative;
+        }
+        return *this;
+    }
+
+    // a -= b where |a| >= |b|
+    static void subtractMagnitudeInPlace(LimbStorage& a, const Limb* b, std::size_t bn) {
+        Limb borrow = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            Limb bi = i < bn ? b[i] : 0;
+            if (i >= bn && borrow == 0) {
+                break;
+            }
+            Limb ai = a[i];
+            Limb diff = ai - bi - borrow;
+            borrow = (ai < bi) || (ai - bi < borrow) ? 1 : 0;
+            a[i] = diff;
+        }
+        a.trim();
+    }
+
+    // Below this many limbs in the shorter operand, schoolbook beats Karatsuba
+    static constexpr std::size_t kKaratsubaThreshold = 32;
+
+    /**
+     * out[0, an + bn) = a * b; out must be zero-filled
+     * Schoolbook for short operands; Karatsuba once both are at least
+     * kKaratsubaThreshold limbs, with a long operand cut into pieces the
+     * size of the short one first.
+     */
+    static void multiplyMagnitudes(const Limb* a, std::size_t an, const Limb* b, std::size_t bn, Limb* out) {
+        if (an < bn) {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        if (bn < kKaratsubaThreshold) {
+            multiplySchoolbook(a, an, b, bn, out);
+            return;
+        }
+        if (an >= 2 * bn) {
+            std::vector<Limb> partial(2 * bn);
+            for (std::size_t offset = 0; offset < an; offset += bn) {
+                const std::size_t length = std::min(bn, an - offset);
+                std::fill(partial.begin(), partial.end(), Limb(0));
+                multiplyMagnitudes(a + offset, length, b, bn, partial.data());
+                addInto(out + offset, an + bn - offset, partial.data(), length + bn);
+            }
+            return;
+        }
+
+        // a = a1·B^m + a0, b = b1·B^m + b0 with bn > m
+        // a·b = z2·B^2m + (z1 - z2 - z0)·B^m + z0, z1 = (a0 + a1)(b0 + b1)
+        const std::size_t m = an / 2;
+        multiplyMagnitudes(a, m, b, m, out);
+        multiplyMagnitudes(a + m, an - m, b + m, bn - m, out + 2 * m);
+
+        std::vector<Limb> sumA(an - m + 1);
+        std::vector<Limb> sumB(std::max(m, bn - m) + 1);
+        const std::size_t sumALength = addMagnitudes(a + m, an - m, a, m, sumA.data());
+        const std::size_t sumBLength = addMagnitudes(b, m, b + m, bn - m, sumB.data());
+        std::vector<Limb> middle(sumALength + sumBLength);
+        multiplyMagnitudes(sumA.data(), sumALength, sumB.data(), sumBLength, middle.data());
+        subtractFrom(middle.data(), middle.size(), out, 2 * m);
+        subtractFrom(middle.data(), middle.size(), out + 2 * m, an + bn - 2 * m);
+
+        std::size_t middleLength = middle.size();
+        while (middleLength > 0 && middle[middleLength - 1] == 0) {
+            --middleLength;
+        }
+        addInto(out + m, an + bn - m, middle.data(), middleLength);
+    }
+
+    static void multiplySchoolbook(const Limb* a, std::size_t an, const Limb* b, std::size_t bn, Limb* out) {
+        for (std::size_t i = 0; i < an; ++i) {
+            Limb carry = 0;
+            Limb ai = a[i];
+            for (std::size_t j = 0; j < bn; ++j) {
+                DoubleLimb t = static_cast<DoubleLimb>(ai) * b[j] + out[i + j] + carry;
+                out[i + j] = static_cast<Limb>(t);
+                carry = static_cast<Limb>(t >> kLimbBits);
+            }
+            out[i + bn] = carry;
+        }
+    }
+
+    // out = x + y with xn >= yn; returns the length used (xn or xn + 1)
+    static std::size_t addMagnitudes(const Limb* x, std::size_t xn, const Limb* y, std::size_t yn, Limb* out) {
+        if (xn < yn) {
+            std::swap(x, y);
+            std::swap(xn, yn);
+        }
+        Limb carry = 0;
+        for (std::size_t i = 0; i < xn; ++i) {
+            DoubleLimb t = static_cast<DoubleLimb>(x[i]) + (i < yn ? y[i] : 0) + carry;
+            out[i] = static_cast<Limb>(t);
+            carry = static_cast<Limb>(t >> kLimbBits);
+        }
+        out[xn] = carry;
+        return carry != 0 ? xn + 1 : xn;
+    }
+
+    // x[0, xn) += y[0, yn); the sum must fit in xn limbs
+    static void addInto(Limb* x, std::size_t xn, const Limb* y, std::size_t yn) {
+        Limb carry = 0;
+        std::size_t i = 0;
+        for (; i < yn; ++i) {
+            DoubleLimb t = static_cast<DoubleLimb>(x[i]) + y[i] + carry;
+            x[i] = static_cast<Limb>(t);
+            carry = static_cast<Limb>(t >> kLimbBits);
+        }
+        for (; carry != 0 && i < xn; ++i) {
+            carry = ++x[i] == 0 ? 1 : 0;
+        }
+    }
+
+    // x[0, xn) -= y[0, yn); x must be at least y
+    static void subtractFrom(Limb* x, std::size_t xn, const Limb* y, std::size_t yn) {
+        Limb borrow = 0;
+        std::size_t i = 0;
+        for (; i < yn; ++i) {
+            Limb yi = y[i];
+            Limb d = x[i] - yi - borrow;
+            borrow = (x[i] < yi || (x[i] == yi && borrow)) ? 1 : 0;
+            x[i] = d;
+        }
+        for (; borrow != 0 && i < xn; ++i) {
+            borrow = x[i]-- == 0 ? 1 : 0;
+        }
+    }
+
+    /**
+     * Knuth's Algorithm D (TAOCP vol. 2, 4.3.1) for divisors of 2+ limbs
+     * Both operands are normalized so the divisor's top bit is set, which
+     * keeps each estimated quotient limb within 2 of the true value.
+     */
+    static void divideMagnitudes(const LimbStorage& u, const LimbStorage& v,
+                                 LimbStorage& quotient, LimbStorage& remainder) {
+        const std::size_t n = v.size();
+        const std::size_t m = u.size() - n;
+        const unsigned shift = static_cast<unsigned>(__builtin_clzll(v.back()));
+
+        LimbStorage vn;
+        vn.resize(n);
+        for (std::size_t i = n; i-- > 0;) {
+            vn[i] = (v[i] << shift) | (shift && i > 0 ? v[i - 1] >> (kLimbBits - shift) : 0);
+        }
+        LimbStorage un;
+        un.resize(u.size() + 1);
+        un[u.size()] = shift ? u[u.size() - 1] >> (kLimbBits - shift) : 0;
+        for (std::size_t i = u.size(); i-- > 0;) {
+            un[i] = (u[i] << shift) | (shift && i > 0 ? u[i - 1] >> (kLimbBits - shift) : 0);
+        }
+
+        quotient.clear();
+        quotient.resize(m + 1);
+        const DoubleLimb base = static_cast<DoubleLimb>(1) << kLimbBits;
+
+        for (std::size_t j = m + 1; j-- > 0;) {
+            // Estimate the quotient limb from the top two limbs
+            DoubleLimb numerator = (static_cast<DoubleLimb>(un[j + n]) << kLimbBits) | un[j + n - 1];
+            DoubleLimb qhat = numerator / vn[n - 1];
+            DoubleLimb rhat = numerator % vn[n - 1];
+            while (qhat >= base ||
+                   qhat * vn[n - 2] > ((rhat << kLimbBits) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= base) {
+                    break;
+                }
+            }
+
+            // Multiply and subtract qhat * vn from the current window
+            Limb borrow = 0;
+            __int128 t = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                DoubleLimb product = qhat * vn[i];
+                t = static_cast<__int128>(un[i + j]) - borrow - static_cast<Limb>(product);
+                un[i + j] = static_cast<Limb>(t);
+                borrow = static_cast<Limb>(product >> kLimbBits) - static_cast<Limb>(t >> kLimbBits);
+            }
+            t = static_cast<__int128>(un[j + n]) - borrow;
+            un[j + n] = static_cast<Limb>(t);
+
+            quotient[j] = static_cast<Limb>(qhat);
+            if (t < 0) {
+                // Estimate was one too large: add the divisor back
+                quotient[j] -= 1;
+                Limb carry = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    DoubleLimb sum = static_cast<DoubleLimb>(un[i + j]) + vn[i] + carry;
+                    un[i + j] = static_cast<Limb>(sum);
+                    carry = static_cast<Limb>(sum >> kLimbBits);
+                }
+                un[j + n] += carry;
+            }
+        }
+        quotient.trim();
+
+        // Un-normalize the remainder
+        remainder.clear();
+        remainder.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            remainder[i] = (un[i] >> shift) | (shift ? un[i + 1] << (kLimbBits - shift) : 0);
+        }
+        remainder.trim();
+    }
+};
+
+/**
+ * Converts base 2-36 digit strings into BigInt
+ *
+ * Digits are handled in groups of 4 (quads): a quad is the value of 4
+ * consecutive digits, at most 36^4 < 2^21. Quads are joined with native
+ * arithmetic into chunks of as many whole quads as fit in a limb (b^m < 2^64:
+ * 40 digits in base 3, 16 in base 10, 12 in base 36), and each chunk costs
+ * the BigInt one mulAddSmall by b^m instead of one per character.
+ * Power-of-two bases need no multiplies and use 8-digit groups (octets).
+ *
+ * With AVX2 (32 characters per step) or SSE4.2 (16), groups are formed
+ * without a per-character loop:
+ *   1. classify: '0'-'9' and 'a'-'z'/'A'-'Z' map to 0-35, everything else
+ *      to 0xFF; an unsigned max over the whole string checks every digit
+ *      against the base in the same pass
+ *   2. fold: pmaddubsw makes d·b + d' for digit pairs, pmaddwd joins pairs
+ *      into quads (p·b² + p'), and for octets a 32x32->64 multiply joins
+ *      quads (q·b⁴ + q')
+ * The scalar fallback uses a 256-entry digit table and the same groups.
+ *
+ * Every step is a template on the base. decode() looks the base up once in
+ * a table of decodeFor<2> ... decodeFor<36>, so inside a conversion the
+ * base, its group powers and the choice of path are constants: digit
+ * multiplies become shifts and LEAs, and the scalar loops unroll.
+ */
+class DigitDecoder {
+    friend class SolverBenchmarks;
+
+public:
+    enum class Kernel { Scalar, Sse42, Avx2 };
+
+    static Kernel bestKernel() {
+#if defined(__x86_64__) && defined(__GNUC__)
+        static const Kernel best = __builtin_cpu_supports("avx2") ? Kernel::Avx2
+                                 : __builtin_cpu_supports("sse4.2") ? Kernel::Sse42
+                                 : Kernel::Scalar;
+        return best;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    /**
+     * Value of an unsigned digit string in the given base
+     * Throws std::invalid_argument for a character that is not a digit of base.
+     */
+    static BigInt decode(std::string_view text, int base, Kernel kernel = bestKernel()) {
+        if (base < 2 || base > 36) {
+            throw std::invalid_argument("Unsupported base: " + std::to_string(base));
+        }
+        return kDecoders[static_cast<std::size_t>(base)](text, base, kernel);
+    }
+
+private:
+    // Template argument for the reference instantiation with a run-time base
+    static constexpr int kRuntimeBase = 0;
+
+    using Decoder = BigInt (*)(std::string_view, int, Kernel);
+    struct DecoderTable {
+        Decoder decoders[37];
+        constexpr DecoderTable() : DecoderTable(std::make_index_sequence<37>{}) {}
+        template <std::size_t... Bases>
+        constexpr DecoderTable(std::index_sequence<Bases...>)
+            : decoders{(Bases >= 2 ? &decodeFor<static_cast<int>(Bases)> : nullptr)...} {}
+        constexpr Decoder operator[](std::size_t base) const { return decoders[base]; }
+    };
+    static const DecoderTable kDecoders;
+
+    /**
+     * Conversion for one base; Base == kRuntimeBase takes it from base
+     */
+    template <int Base>
+    static BigInt decodeFor(std::string_view text, int base, Kernel kernel) {
+        base = fixedBase<Base>(base);
+        if ((base & (base - 1)) == 0) {
+            return decodePowerOfTwo<Base>(text, base, kernel);
+        }
+        if (text.size() > kSplitDigits) {
+            return decodeSplit<Base>(text, base, kernel);
+        }
+        return decodeLinear<Base>(text, base, kernel);
+    }
+
+    // The base as a constant wherever the instantiation fixes it
+    template <int Base>
+    static constexpr int fixedBase(int base) {
+        return Base == kRuntimeBase ? base : Base;
+    }
+
+    // Groups are quads for chunked Horner and octets for power-of-two bases
+    static constexpr std::size_t kQuadDigits = 4;
+    static constexpr std::size_t kOctetDigits = 8;
+    // A multiple of the SIMD step and of every chunk size (3, 4, 5, 6 and 10 groups)
+    static constexpr std::size_t kBatchGroups = 120;
+    // Longer strings are split recursively; at or below it Horner is faster
+    static constexpr std::size_t kSplitDigits = 2048;
+
+    /**
+     * Subquadratic conversion for long strings
+     *
+     * The string is cut into a high part and a low part of L·2^i digits
+     * (L = kSplitDigits, low part at least half), and
+     *
+     *   value = high · b^(L·2^i) + low
+     *
+     * recursively down to L-digit leaves. The powers b^(L·2^i) are built
+     * once by repeated squaring, so with Karatsuba products the cost is
+     * O(M(d) log d) for d digits instead of Horner's O(d²).
+     */
+    template <int Base>
+    static BigInt decodeSplit(std::string_view text, int base, Kernel kernel) {
+        base = fixedBase<Base>(base);
+        std::vector<BigInt> powers;
+        const ChunkPlan& plan = kChunkPlans[static_cast<std::size_t>(base)];
+        const std::size_t leafGroups = kSplitDigits / kQuadDigits;
+        BigInt leafScale(1);
+        for (std::size_t i = 0; i < leafGroups / plan.groups; ++i) {
+            leafScale.mulAddSmall(plan.scale, 0);
+        }
+        if (leafGroups % plan.groups != 0) {
+            leafScale.mulAddSmall(plan.weights[plan.groups - 1 - leafGroups % plan.groups], 0);
+        }
+        powers.push_back(std::move(leafScale));
+        while ((kSplitDigits << powers.size()) < text.size()) {
+            powers.push_back(powers.back() * powers.back());
+        }
+        return splitConvert<Base>(text, base, kernel, powers);
+    }
+
+    template <int Base>
+    static BigInt splitConvert(std::string_view text, int base, Kernel kernel, const std::vector<BigInt>& powers) {
+        if (text.size() <= kSplitDigits) {
+            return decodeLinear<Base>(text, base, kernel);
+        }
+        std::size_t level = 0;
+        while ((kSplitDigits << (level + 1)) < text.size()) {
+            ++level;
+        }
+        const std::size_t lowDigits = kSplitDigits << level;
+        BigInt result = splitConvert<Base>(text.substr(0, text.size() - lowDigits), base, kernel, powers) *
+                        powers[level];
+        result += splitConvert<Base>(text.substr(text.size() - lowDigits), base, kernel, powers);
+        return result;
+    }
+
+    /**
+     * Horner over limb-sized chunks of quads; quadratic, but the fastest
+     * way for strings up to kSplitDigits
+     */
+    template <int Base>
+    static BigInt decodeLinear(std::string_view text, int base, Kernel kernel) {
+        base = fixedBase<Base>(base);
+        const std::size_t lead = text.size() % kQuadDigits;
+        unsigned char maxDigit = 0;
+        BigInt result(leadDigits<Base>(text, lead, base, maxDigit));
+        result.reserveLimbs(text.size() * 6 / BigInt::kLimbBits + 2);
+
+        // A chunk is a dot product with the quad weights, so its multiplies
+        // do not wait on each other; only the last one may be short
+        const ChunkPlan& plan = kChunkPlans[static_cast<std::size_t>(base)];
+        const std::size_t chunkGroups = plan.groups;
+        convertGroups<Base, kQuadDigits>(text.substr(lead), base, kernel, maxDigit,
+                                         [&](const std::uint64_t* groups, std::size_t count, std::size_t) {
+            std::size_t g = 0;
+            for (; g + chunkGroups <= count; g += chunkGroups) {
+                std::uint64_t chunk = 0;
+                for (std::size_t j = 0; j < chunkGroups; ++j) {
+                    chunk += groups[g + j] * plan.weights[j];
+                }
+                result.mulAddSmall(plan.scale, chunk);
+            }
+            if (g < count) {
+                const std::size_t rest = count - g;
+                std::uint64_t chunk = 0;
+                for (std::size_t j = 0; j < rest; ++j) {
+                    chunk += groups[g + j] * plan.weights[chunkGroups - rest + j];
+                }
+                result.mulAddSmall(plan.weights[chunkGroups - 1 - rest], chunk);
+            }
+        });
+        if (maxDigit >= base) {
+            throwInvalidDigit(text, base);
+        }
+        return result;
+    }
+
+    // Base 3 chunks, 40 digits
+    static constexpr std::size_t kMaxChunkGroups = 10;
+
+    /**
+     * Per base: the most quads whose value fits in a limb, b^(4·groups),
+     * and the weight b^(4·(groups-1-j)) of the j-th quad in a chunk
+     */
+    struct ChunkPlan {
+        std::size_t groups = 0;
+        std::uint64_t scale = 0;
+        std::uint64_t weights[kMaxChunkGroups] = {};
+    };
+    struct ChunkPlanTable {
+        ChunkPlan plans[37];
+        constexpr ChunkPlanTable() : plans() {
+            for (int base = 2; base <= 36; ++base) {
+                ChunkPlan& plan = plans[base];
+                const std::uint64_t groupScale = power(base, kQuadDigits);
+                plan.scale = 1;
+                while (plan.groups < kMaxChunkGroups &&
+                       plan.scale <= std::numeric_limits<std::uint64_t>::max() / groupScale) {
+                    plan.scale *= groupScale;
+                    ++plan.groups;
+                }
+                std::uint64_t weight = 1;
+                for (std::size_t j = plan.groups; j-- > 0;) {
+                    plan.weights[j] = weight;
+                    weight *= groupScale;
+                }
+            }
+        }
+        constexpr const ChunkPlan& operator[](std::size_t base) const { return plans[base]; }
+    };
+    static const ChunkPlanTable kChunkPlans;
+
+    /**
+     * Bases 2, 4, 8, 16 and 32: every digit is exactly s = log2(b) bits
+     * Octets come from the same kernels (their weights are powers of two)
+     * and are then OR-ed into place at bit offset 8s·(octets after it), so
+     * the whole conversion is linear and needs no BigInt arithmetic.
+     */
+    template <int Base>
+    static BigInt decodePowerOfTwo(std::string_view text, int base, Kernel kernel) {
+        base = fixedBase<Base>(base);
+        const unsigned bitsPerDigit = static_cast<unsigned>(__builtin_ctz(static_cast<unsigned>(base)));
+        const std::size_t groupBits = kOctetDigits * bitsPerDigit;
+        const std::size_t lead = text.size() % kOctetDigits;
+        const std::size_t groupCount = text.size() / kOctetDigits;
+        const std::size_t totalBits = text.size() * bitsPerDigit;
+
+        unsigned char maxDigit = 0;
+        BigInt result = BigInt::fromLimbs((totalBits + BigInt::kLimbBits - 1) / BigInt::kLimbBits,
+                                          [&](BigInt::Limb* limbs) {
+            // value has width bits and lands at bit offset
+            auto place = [&](std::uint64_t value, std::size_t offset, std::size_t width) {
+                const std::size_t index = offset / BigInt::kLimbBits;
+                const unsigned shift = static_cast<unsigned>(offset % BigInt::kLimbBits);
+                limbs[index] |= value << shift;
+                if (shift != 0 && shift + width > BigInt::kLimbBits) {
+                    limbs[index + 1] |= value >> (BigInt::kLimbBits - shift);
+                }
+            };
+            const std::uint64_t leadValue = leadDigits<Base>(text, lead, base, maxDigit);
+            if (leadValue != 0) {
+                place(leadValue, groupCount * groupBits, lead * bitsPerDigit);
+            }
+            convertGroups<Base, kOctetDigits>(text.substr(lead), base, kernel, maxDigit,
+                                        [&](const std::uint64_t* groups, std::size_t count, std::size_t first) {
+                for (std::size_t g = 0; g < count; ++g) {
+                    place(groups[g], (groupCount - 1 - (first + g)) * groupBits, groupBits);
+                }
+            });
+        });
+        if (maxDigit >= base) {
+            throwInvalidDigit(text, base);
+        }
+        return result;
+    }
+
+    // Value of the first lead digits, ahead of the first whole group
+    template <int Base>
+    static std::uint64_t leadDigits(std::string_view text, std::size_t lead, int base, unsigned char& maxDigit) {
+        base = fixedBase<Base>(base);
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < lead; ++i) {
+            unsigned char digit = kDigitTable[static_cast<unsigned char>(text[i])];
+            maxDigit = std::max(maxDigit, digit);
+            value = value * static_cast<std::uint64_t>(base) + digit;
+        }
+        return value;
+    }
+
+    /**
+     * Converts text (a whole number of Digits-digit groups) batch by batch
+     * through a stack buffer: onBatch(groups, count, index of the first group)
+     * Digit values are folded into maxDigit for the caller to validate.
+     */
+    template <int Base, std::size_t Digits, typename OnBatch>
+    static void convertGroups(std::string_view text, int base, Kernel kernel, unsigned char& maxDigit,
+                              OnBatch onBatch) {
+        base = fixedBase<Base>(base);
+        const std::size_t groupCount = text.size() / Digits;
+        std::uint64_t groups[kBatchGroups];
+        for (std::size_t first = 0; first < groupCount; first += kBatchGroups) {
+            const std::size_t count = std::min(kBatchGroups, groupCount - first);
+            const char* batch = text.data() + first * Digits;
+            std::size_t done = 0;
+#if defined(__x86_64__) && defined(__GNUC__)
+            if (kernel == Kernel::Avx2) {
+                done = groupsAvx2<Digits>(batch, count, base, groups, maxDigit);
+            } else if (kernel == Kernel::Sse42) {
+                done = groupsSse42<Digits>(batch, count, base, groups, maxDigit);
+            }
+#else
+            (void)kernel;
+#endif
+            for (std::size_t g = done; g < count; ++g) {
+                std::uint64_t group = 0;
+                for (std::size_t i = 0; i < Digits; ++i) {
+                    unsigned char digit = kDigitTable[static_cast<unsigned char>(batch[g * Digits + i])];
+                    maxDigit = std::max(maxDigit, digit);
+                    group = group * static_cast<std::uint64_t>(base) + digit;
+                }
+                groups[g] = group;
+            }
+            onBatch(groups, count, first);
+        }
+    }
+
+    struct DigitTable {
+        unsigned char values[256];
+        constexpr DigitTable() : values() {
+            for (int c = 0; c < 256; ++c) {
+                values[c] = c >= '0' && c <= '9' ? static_cast<unsigned char>(c - '0')
+                          : c >= 'a' && c <= 'z' ? static_cast<unsigned char>(c - 'a' + 10)
+                          : c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c - 'A' + 10)
+                          : 0xFF;
+            }
+        }
+        constexpr unsigned char operator[](unsigned char c) const { return values[c]; }
+    };
+    static const DigitTable kDigitTable;
+
+    static constexpr std::uint64_t power(int base, std::size_t exponent) {
+        std::uint64_t result = 1;
+        for (std::size_t i = 0; i < exponent; ++i) {
+            result *= static_cast<std::uint64_t>(base);
+        }
+        return result;
+    }
+
+    // Slow path for the error message: names the first offending character
+    [[noreturn]] static void throwInvalidDigit(std::string_view text, int base) {
+        for (char c : text) {
+            unsigned char digit = kDigitTable[static_cast<unsigned char>(c)];
+            if (digit == 0xFF) {
+                throw std::invalid_argument("Invalid character in base conversion: " + std::string(1, c));
+            }
+            if (digit >= base) {
+                throw std::invalid_argument("Digit value " + std::to_string(digit) +
+                                            " is invalid for base " + std::to_string(base));
+            }
+        }
+        throw std::logic_error("throwInvalidDigit called on a valid digit string");
+    }
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    // 32 characters (8 quads or 4 octets) per step; returns the number of groups done
+    template <std::size_t Digits>
+    __attribute__((target("avx2")))
+    static std::size_t groupsAvx2(const char* text, std::size_t groupCount, int base,
+                                  std::uint64_t* groups, unsigned char& maxDigit) {
+        static_assert(Digits == kQuadDigits || Digits == kOctetDigits, "groups are quads or octets");
+        constexpr std::size_t kStep = 32 / Digits;
+        // Little-endian lanes: (b, 1) byte pairs and (b², 1) word pairs, most significant first
+        const __m256i pairWeights = _mm256_set1_epi16(static_cast<short>((1 << 8) | base));
+        const __m256i quadWeights = _mm256_set1_epi32((1 << 16) | (base * base));
+        const __m256i octetWeight = _mm256_set1_epi64x(static_cast<long long>(base) * base * base * base);
+        __m256i maxima = _mm256_setzero_si256();
+        std::size_t g = 0;
+        for (; g + kStep <= groupCount; g += kStep) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + g * Digits));
+            __m256i decimal = _mm256_sub_epi8(chunk, _mm256_set1_epi8('0'));
+            __m256i letter = _mm256_sub_epi8(_mm256_or_si256(chunk, _mm256_set1_epi8(0x20)),
+                                             _mm256_set1_epi8('a'));
+            __m256i isDecimal = _mm256_cmpeq_epi8(_mm256_max_epu8(decimal, _mm256_set1_epi8(9)),
+                                                  _mm256_set1_epi8(9));
+            __m256i isLetter = _mm256_cmpeq_epi8(_mm256_max_epu8(letter, _mm256_set1_epi8(25)),
+                                                 _mm256_set1_epi8(25));
+            __m256i digits = _mm256_blendv_epi8(_mm256_set1_epi8(static_cast<char>(0xFF)),
+                                                _mm256_add_epi8(letter, _mm256_set1_epi8(10)), isLetter);
+            digits = _mm256_blendv_epi8(digits, decimal, isDecimal);
+            maxima = _mm256_max_epu8(maxima, digits);
+
+            __m256i pairs = _mm256_maddubs_epi16(digits, pairWeights);
+            __m256i quads = _mm256_madd_epi16(pairs, quadWeights);
+            if constexpr (Digits == kOctetDigits) {
+                __m256i octets = _mm256_add_epi64(_mm256_mul_epu32(quads, octetWeight),
+                                                  _mm256_srli_epi64(quads, 32));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(groups + g), octets);
+            } else {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(groups + g),
+                                    _mm256_cvtepu32_epi64(_mm256_castsi256_si128(quads)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(groups + g + 4),
+                                    _mm256_cvtepu32_epi64(_mm256_extracti128_si256(quads, 1)));
+            }
+        }
+        alignas(32) unsigned char lanes[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), maxima);
+        for (unsigned char lane : lanes) {
+            maxDigit = std::max(maxDigit, lane);
+        }
+        return g;
+    }
+
+    // 16 characters (4 quads or 2 octets) per step
+    template <std::size_t Digits>
+    __attribute__((target("sse4.2")))
+    static std::size_t groupsSse42(const char* text, std::size_t groupCount, int base,
+                                   std::uint64_t* groups, unsigned char& maxDigit) {
+        static_assert(Digits == kQuadDigits || Digits == kOctetDigits, "groups are quads or octets");
+        constexpr std::size_t kStep = 16 / Digits;
+        const __m128i pairWeights = _mm_set1_epi16(static_cast<short>((1 << 8) | base));
+        const __m128i quadWeights = _mm_set1_epi32((1 << 16) | (base * base));
+        const __m128i octetWeight = _mm_set1_epi64x(static_cast<long long>(base) * base * base * base);
+        __m128i maxima = _mm_setzero_si128();
+        std::size_t g = 0;
+        for (; g + kStep <= groupCount; g += kStep) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + g * Digits));
+            __m128i decimal = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+            __m128i letter = _mm_sub_epi8(_mm_or_si128(chunk, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            __m128i isDecimal = _mm_cmpeq_epi8(_mm_max_epu8(decimal, _mm_set1_epi8(9)), _mm_set1_epi8(9));
+            __m128i isLetter = _mm_cmpeq_epi8(_mm_max_epu8(letter, _mm_set1_epi8(25)), _mm_set1_epi8(25));
+            __m128i digits = _mm_blendv_epi8(_mm_set1_epi8(static_cast<char>(0xFF)),
+                                             _mm_add_epi8(letter, _mm_set1_epi8(10)), isLetter);
+            digits = _mm_blendv_epi8(digits, decimal, isDecimal);
+            maxima = _mm_max_epu8(maxima, digits);
+
+            __m128i pairs = _mm_maddubs_epi16(digits, pairWeights);
+            __m128i quads = _mm_madd_epi16(pairs, quadWeights);
+            if constexpr (Digits == kOctetDigits) {
+                __m128i octets = _mm_add_epi64(_mm_mul_epu32(quads, octetWeight), _mm_srli_epi64(quads, 32));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(groups + g), octets);
+            } else {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(groups + g), _mm_cvtepu32_epi64(quads));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(groups + g + 2),
+                                 _mm_cvtepu32_epi64(_mm_srli_si128(quads, 8)));
+            }
+        }
+        alignas(16) unsigned char lanes[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), maxima);
+        for (unsigned char lane : lanes) {
+            maxDigit = std::max(maxDigit, lane);
+        }
+        return g;
+    }
+#endif
+};
+
+// Digit value of every byte, filled in at compile time
+const DigitDecoder::DigitTable DigitDecoder::kDigitTable{};
+// decodeFor<base> for bases 2-36, also filled in at compile time
+const DigitDecoder::DecoderTable DigitDecoder::kDecoders{};
+const DigitDecoder::ChunkPlanTable DigitDecoder::kChunkPlans{};
+
+/**
+ * Simple JSON Parser for our specific use case
+ * Parses the JSON structure used in test cases without external dependencies
+ *
+ * A hand-written single-pass tokenizer over SIMD-classified 64-byte blocks.
+ * Strings come back as std::string_view into the caller's buffer, so nothing
+ * is copied or allocated per token. Whitespace and member order are free;
+ * any member the solver does not use is skipped.
+ */
+class SimpleJsonParser {
+public:
+    /**
+     * One share entry: "<index>": {"base": "<base>", "value": "<value>"}
+     */
+    struct ShareEntry {
+        std::string_view index;
+        std::string_view base;
+        std::string_view value;
+    };
+
+    /**
+     * The "keys" object: {"n": <n>, "k": <k>}
+     */
+    struct Keys {
+        std::string_view n;
+        std::string_view k;
+    };
+
+    /**
+     * Parsed test case; every view points into the parsed text
+     */
+    struct Document {
+        Keys keys;
+        std::vector<ShareEntry> shares;
+    };
+
+    /**
+     * Parses a test case held in memory, handing entries to the handler as
+     * they are read: handler.keys(Keys) once, handler.share(ShareEntry) per
+     * share, in file order. Nothing is buffered in between.
+     *
+     * JSON Structure:
+     * {
+     *   "keys": {"n": 4, "k": 3},
+     *   "1": {"base": "10", "value": "4"},
+     *   ...
+     * }
+     */
+    template <typename Handler>
+    static void parse(std::string_view text, Handler& handler) {
+        Cursor cursor(text);
+        bool sawKeys = false;
+
+        cursor.expect('{');
+        if (!cursor.consumeIf('}')) {
+            do {
+                parseMember(cursor, handler, sawKeys);
+            } while (cursor.consumeIf(','));
+            cursor.expect('}');
+        }
+        if (!cursor.atEnd()) {
+            cursor.fail("trailing characters after the top-level object");
+        }
+        if (!sawKeys) {
+            throw std::runtime_error("JSON parsing failed: missing \"keys\" with \"n\" and \"k\"");
+        }
+    }
+
+    /**
+     * Parses a test case from a stream, reading it chunk by chunk
+     * 
+     * Same handler protocol as parse(), but only the member being read is
+     * held in memory: each top-level member is cut out as soon as its
+     * closing ',' or '}' arrives and handed over before the next chunk is
+     * read. Views passed to the handler are valid only during the call.
+     */
+    template <typename Handler>
+    static void parseStream(std::istream& in, Handler& handler) {
+        enum class Stage { BeforeObject, BeforeMember, InMember, AfterObject };
+        Stage stage = Stage::BeforeObject;
+        std::string member;            // bytes of the member being read
+        std::size_t memberOffset = 0;  // its position in the whole input
+        std::size_t consumed = 0;      // input bytes before the current chunk
+        int depth = 0;                 // nesting inside the member's value
+        bool inString = false;
+        bool escaped = false;
+        bool sawMember = false;
+        bool sawKeys = false;
+        
+        auto streamError = [](const std::string& message, std::size_t offset) {
+            return std::runtime_error("JSON parsing failed: " + message + " at offset " +
+                                      std::to_string(offset));
+        };
+        
+        std::vector<char> chunk(kStreamChunk);
+        while (in) {
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            const std::size_t got = static_cast<std::size_t>(in.gcount());
+            if (got == 0) {
+                break;
+            }
+            const char* data = chunk.data();
+            std::size_t from = 0;  // start of the member bytes not yet copied
+            
+            for (std::size_t i = 0; i < got; ++i) {
+                const char c = data[i];
+                if (stage == Stage::InMember) {
+                    if (inString) {
+                        if (escaped) {
+                            escaped = false;
+                        } else if (c == '\\') {
+                            escaped = true;
+                        } else if (c == '"') {
+                            inString = false;
+                        }
+                        continue;
+                    }
+                    if (c == '"') {
+                        inString = true;
+                    } else if (c == '{' || c == '[') {
+                        ++depth;
+                    } else if ((c == '}' || c == ']') && depth > 0) {
+                        --depth;
+                    } else if ((c == ',' || c == '}') && depth == 0) {
+                        // Member complete: parse it in place with the regular cursor
+                        member.append(data + from, i - from);
+                        Cursor cursor(member, memberOffset);
+                        parseMember(cursor, handler, sawKeys);
+                        if (!cursor.atEnd()) {
+                            cursor.fail("expected ',' or '}'");
+                        }
+                        member.clear();
+                        sawMember = true;
+                        stage = c == ',' ? Stage::BeforeMember : Stage::AfterObject;
+                    }
+                    continue;
+                }
+                
+                if (static_cast<unsigned char>(c) <= ' ') {
+                    continue;
+                }
+                if (stage == Stage::BeforeObject) {
+                    if (c != '{') {
+                        throw streamError("expected '{'", consumed + i);
+                    }
+                    stage = Stage::BeforeMember;
+                } else if (stage == Stage::BeforeMember) {
+                    if (c == '}' && !sawMember) {
+                        stage = Stage::AfterObject;  // {}
+                        continue;
+                    }
+                    if (c != '"') {
+                        throw streamError("expected '\"'", consumed + i);
+                    }
+                    stage = Stage::InMember;
+                    memberOffset = consumed + i;
+                    from = i;
+                    depth = 0;
+                    inString = true;
+                    escaped = false;
+                } else {
+                    throw streamError("trailing characters after the top-level object", consumed + i);
+                }
+            }
+            
+            if (stage == Stage::InMember) {
+                member.append(data + from, got - from);
+            }
+            consumed += got;
+        }
+        
+        if (in.bad()) {
+            throw std::runtime_error("JSON parsing failed: read error");
+        }
+        if (stage != Stage::AfterObject) {
+            throw streamError("unexpected end of input", consumed);
+        }
+        if (!sawKeys) {
+            throw std::runtime_error("JSON parsing failed: missing \"keys\" with \"n\" and \"k\"");
+        }
+    }
+
+    /**
+     * Parses a test case held in memory into a Document
+     */
+    static Document parse(std::string_view text) {
+        struct Collector {
+            Document document;
+            void keys(const Keys& keys) {
+                document.keys = keys;
+                document.shares.reserve(parseCount(keys.n));
+            }
+            void share(const ShareEntry& share) { document.shares.push_back(share); }
+        } collector;
+        parse(text, collector);
+        return std::move(collector.document);
+    }
+
+    /**
+     * Read-only view of an input file's bytes
+     * Regular files are memory-mapped and parsed in place (MADV_SEQUENTIAL,
+     * so pages stream in ahead of the cursor and can be dropped behind it).
+     * Pipes, stdin ("-") and files mmap refuses are read with read() into
+     * an owned buffer instead.
+     */
+    class Input {
+    public:
+        explicit Input(const std::string& filename) {
+#ifdef POLYSOLVER_HAVE_MMAP
+            int fd = filename == "-" ? STDIN_FILENO : ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Cannot open file: " + filename);
+            }
+            
+            struct stat info;
+            bool regular = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+            if (regular && info.st_size > 0) {
+                void* map = ::mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                                   PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map != MAP_FAILED) {
+                    map_ = map;
+                    mapLength_ = static_cast<std::size_t>(info.st_size);
+                    ::madvise(map_, mapLength_, MADV_SEQUENTIAL);
+                    text_ = std::string_view(static_cast<const char*>(map_), mapLength_);
+                }
+            }
+            
+            if (map_ == nullptr) {
+                try {
+                    readAll(fd, regular ? static_cast<std::size_t>(info.st_size) : 0);
+                } catch (const std::runtime_error&) {
+                    if (fd != STDIN_FILENO) ::close(fd);
+                    throw std::runtime_error("Cannot read file: " + filename);
+                }
+            }
+            if (fd != STDIN_FILENO) {
+                ::close(fd);
+            }
+#else
+            std::ifstream file(filename, std::ios::binary | std::ios::ate);
+            if (!file.is_open()) {
+                throw std::runtime_error("Cannot open file: " + filename);
+            }
+            buffer_.resize(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(&buffer_[0], static_cast<std::streamsize>(buffer_.size()));
+            text_ = buffer_;
+#endif
+        }
+        
+        ~Input() {
+#ifdef POLYSOLVER_HAVE_MMAP
+            if (map_ != nullptr) {
+                ::munmap(map_, mapLength_);
+            }
+#endif
+        }
+        
+        Input(const Input&) = delete;
+        Input& operator=(const Input&) = delete;
+        
+        std::string_view text() const { return text_; }
+        bool isMapped() const { return map_ != nullptr; }
+        
+    private:
+        void* map_ = nullptr;
+        std::size_t mapLength_ = 0;
+        std::pmr::string buffer_{FileArena::resource()};
+        std::string_view text_;
+        
+#ifdef POLYSOLVER_HAVE_MMAP
+        // Buffered fallback: large read() calls into a geometrically grown buffer
+        void readAll(int fd, std::size_t sizeHint) {
+            buffer_.resize(std::max<std::size_t>(sizeHint + 1, std::size_t(1) << 16));
+            std::size_t used = 0;
+            for (;;) {
+                if (used == buffer_.size()) {
+                    buffer_.resize(buffer_.size() * 2);
+                }
+                ssize_t got = ::read(fd, &buffer_[used], buffer_.size() - used);
+                if (got < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error("read failed");
+                }
+                if (got == 0) break;
+                used += static_cast<std::size_t>(got);
+            }
+            buffer_.resize(used);
+            text_ = buffer_;
+        }
+#endif
+    };
+
+    /**
+     * Parses a non-negative decimal count such as "n" or "k"
+     * Returns 0 for anything else, so it is only a sizing hint.
+     */
+    static std::size_t parseCount(std::string_view text) {
+        std::size_t value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9' || value > (std::size_t(1) << 32)) {
+                return 0;
+            }
+            value = value * 10 + static_cast<std::size_t>(c - '0');
+        }
+        return value;
+    }
+
+private:
+    /**
+     * Structural cursor over the input text
+     *
+     * The text is classified 64 bytes at a time into bitmasks (AVX2 or SSE2
+     * when the CPU has them): quotes, whitespace and {}[]:, punctuation. A prefix XOR of
+     * the quote mask marks the bytes inside strings, which leaves one bit per
+     * token start: punctuation, opening quotes and the first byte of each bare
+     * scalar. The parser walks those bits with ctz, so whitespace and string
+     * bodies are never visited byte by byte. Strings that run past the
+     * current block are finished with memchr and classification restarts
+     * after the closing quote.
+     */
+    class Cursor {
+    public:
+        // offset is where text starts in the whole input, for error messages
+        explicit Cursor(std::string_view text, std::size_t offset = 0)
+            : begin_(text.data()), end_(text.data() + text.size()), offset_(offset) {
+            classify(begin_);
+        }
+
+        bool atEnd() { return !ensureToken(); }
+
+        char peek() {
+            if (!ensureToken()) {
+                fail("unexpected end of input");
+            }
+            return *current();
+        }
+
+        void expect(char c) {
+            if (peek() != c) {
+                fail(std::string("expected '") + c + "'");
+            }
+            advance();
+        }
+
+        bool consumeIf(char c) {
+            if (peek() == c) {
+                advance();
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * Returns the raw contents of a string literal (escapes are left as-is)
+         */
+        std::string_view readString() {
+            if (peek() != '"') {
+                fail("expected '\"'");
+            }
+            const char* open = current();
+            const std::size_t bit = static_cast<std::size_t>(open - block_);
+            const std::uint64_t later = bit == 63 ? 0 : quotes_ & (~std::uint64_t(0) << (bit + 1));
+            const char* close = nullptr;
+            if (later != 0) {
+                // Closes inside this block; the bits after it are already right
+                close = block_ + __builtin_ctzll(later);
+                advance();
+            } else {
+                close = findClosingQuote(open);
+                restartAt(close + 1);
+            }
+            return std::string_view(open + 1, static_cast<std::size_t>(close - open - 1));
+        }
+
+        /**
+         * Reads a number or string scalar and returns its text
+         */
+        std::string_view readScalar() {
+            if (peek() == '"') {
+                return readString();
+            }
+            const char* start = current();
+            const char* stop = start;
+            while (stop != end_ && !isDelimiter(*stop)) {
+                ++stop;
+            }
+            advance();
+            return std::string_view(start, static_cast<std::size_t>(stop - start));
+        }
+
+        // Skips any JSON value, including nested objects and arrays
+        void skipValue() {
+            char c = peek();
+            if (c == '{' || c == '[') {
+                char close = c == '{' ? '}' : ']';
+                advance();
+                if (consumeIf(close)) {
+                    return;
+                }
+                do {
+                    if (c == '{') {
+                        readString();
+                        expect(':');
+                    }
+                    skipValue();
+                } while (consumeIf(','));
+                expect(close);
+            } else {
+                readScalar();
+            }
+        }
+
+        [[noreturn]] void fail(const std::string& message) const {
+            const char* at = tokens_ != 0 ? current() : end_;
+            throw std::runtime_error("JSON parsing failed: " + message + " at offset " +
+                                     std::to_string(offset_ + static_cast<std::size_t>(at - begin_)));
+        }
+
+    private:
+        static constexpr std::size_t kBlock = 64;
+
+        const char* begin_;
+        const char* end_;
+        std::size_t offset_;                // position of begin_ in the whole input
+        const char* block_ = nullptr;       // start of the classified block
+        std::uint64_t tokens_ = 0;          // remaining token starts in the block
+        std::uint64_t quotes_ = 0;          // unescaped quotes in the block
+        std::uint64_t inStringCarry_ = 0;   // all ones if the block starts inside a string
+        std::uint64_t scalarCarry_ = 0;     // 1 if the previous byte was part of a scalar
+        bool escapeCarry_ = false;          // previous block ended on an unpaired backslash
+
+        static bool isDelimiter(char c) {
+            return static_cast<unsigned char>(c) <= ' ' || c == ',' || c == ':' ||
+                   c == '{' || c == '}' || c == '[' || c == ']' || c == '"';
+        }
+
+        const char* current() const { return block_ + __builtin_ctzll(tokens_); }
+
+        void advance() { tokens_ &= tokens_ - 1; }
+
+        bool ensureToken() {
+            while (tokens_ == 0) {
+                if (end_ - block_ <= static_cast<std::ptrdiff_t>(kBlock)) {
+                    return false;
+                }
+                classify(block_ + kBlock);
+            }
+            return true;
+        }
+
+        // Resumes classification right after a string, outside of it
+        void restartAt(const char* position) {
+            inStringCarry_ = 0;
+            scalarCarry_ = 0;
+            escapeCarry_ = false;
+            classify(position);
+        }
+
+        // Closing quote of a string that continues past the current block
+        const char* findClosingQuote(const char* open) const {
+            const char* from = std::max(open + 1, block_ + kBlock);
+            for (;;) {
+                const char* quote = from < end_
+                    ? static_cast<const char*>(std::memchr(from, '"', static_cast<std::size_t>(end_ - from)))
+                    : nullptr;
+                if (quote == nullptr) {
+                    throw std::runtime_error("JSON parsing failed: unterminated string at offset " +
+                                             std::to_string(offset_ + static_cast<std::size_t>(open - begin_)));
+                }
+                // A quote preceded by an odd number of backslashes is escaped
+                std::size_t backslashes = 0;
+                while (quote - backslashes - 1 > open && quote[-1 - static_cast<std::ptrdiff_t>(backslashes)] == '\\') {
+                    ++backslashes;
+                }
+                if (backslashes % 2 == 0) {
+                    return quote;
+                }
+                from = quote + 1;
+            }
+        }
+
+        /**
+         * Computes the token bitmask for the 64 bytes starting at start
+         */
+        void classify(const char* start) {
+            block_ = start;
+            const std::ptrdiff_t available = end_ - start;
+            if (available <= 0) {
+                tokens_ = 0;
+                quotes_ = 0;
+                return;
+            }
+
+            // The last partial block is classified from a space-padded copy
+            alignas(16) char padded[kBlock];
+            const char* bytes = start;
+            if (available < static_cast<std::ptrdiff_t>(kBlock)) {
+                std::memset(padded, ' ', kBlock);
+                std::memcpy(padded, start, static_cast<std::size_t>(available));
+                bytes = padded;
+            }
+
+            BlockMasks masks = classifyBlock(bytes);
+            std::uint64_t quote = masks.quote;
+            if (masks.backslash != 0 || escapeCarry_) {
+                quote &= ~escapedPositions(bytes);
+            }
+
+            // Prefix XOR: bit i is set when an odd number of quotes precede
+            // or sit at position i, i.e. inside a string (opening quote included)
+            std::uint64_t inString = prefixXor(quote) ^ inStringCarry_;
+            inStringCarry_ = static_cast<std::uint64_t>(static_cast<std::int64_t>(inString) >> 63);
+
+            const std::uint64_t scalar = ~(masks.space | masks.structural | quote | inString);
+            const std::uint64_t scalarStart = scalar & ~((scalar << 1) | scalarCarry_);
+            scalarCarry_ = scalar >> 63;
+
+            quotes_ = quote;
+            tokens_ = (masks.structural & ~inString) | (quote & inString) | scalarStart;
+        }
+        /**
+         * Per-byte character classes of one 64-byte block
+         */
+        struct BlockMasks {
+            std::uint64_t quote = 0;
+            std::uint64_t backslash = 0;
+            std::uint64_t space = 0;       // any byte <= ' ' (control bytes are not valid JSON anyway)
+            std::uint64_t structural = 0;  // { } [ ] : ,
+        };
+
+        static std::uint64_t prefixXor(std::uint64_t bits) {
+            for (int shift = 1; shift < 64; shift <<= 1) {
+                bits ^= bits << shift;
+            }
+            return bits;
+        }
+
+#if defined(__x86_64__) && defined(__GNUC__)
+        // 2 x 32 bytes per block when the CPU has AVX2
+        __attribute__((target("avx2"))) static BlockMasks classifyAvx2(const char* bytes) {
+            BlockMasks masks;
+            for (std::size_t offset = 0; offset < kBlock; offset += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + offset));
+                __m256i quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+                __m256i backslash = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+                __m256i space = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, _mm256_set1_epi8(' ')),
+                                                  _mm256_set1_epi8(' '));
+                // '[' and ']' become '{' and '}' once bit 5 is set
+                __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+                __m256i structural = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                                    _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')),
+                                    _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))));
+                masks.quote |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(quote))) << offset;
+                masks.backslash |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(backslash))) << offset;
+                masks.space |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(space))) << offset;
+                masks.structural |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(structural))) << offset;
+            }
+            return masks;
+        }
+#endif
+
+        static BlockMasks classifyPortable(const char* bytes) {
+            BlockMasks masks;
+#ifdef __SSE2__
+            for (std::size_t offset = 0; offset < kBlock; offset += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+                auto bits = [&](__m128i hits) {
+                    return static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(hits))) << offset;
+                };
+                masks.quote |= bits(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+                masks.backslash |= bits(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+                masks.space |= bits(_mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(' ')), _mm_set1_epi8(' ')));
+                __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+                masks.structural |= bits(_mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')),
+                                 _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')),
+                                 _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))));
+            }
+#else
+            for (std::size_t i = 0; i < kBlock; ++i) {
+                const std::uint64_t bit = std::uint64_t(1) << i;
+                switch (bytes[i]) {
+                    case '"': masks.quote |= bit; break;
+                    case '\\': masks.backslash |= bit; break;
+                    case '{': case '}': case ':': case ',': case '[': case ']': masks.structural |= bit; break;
+                    default:
+                        if (static_cast<unsigned char>(bytes[i]) <= ' ') {
+                            masks.space |= bit;
+                        }
+                        break;
+                }
+            }
+#endif
+            return masks;
+        }
+
+        static BlockMasks classifyBlock(const char* bytes) {
+#if defined(__x86_64__) && defined(__GNUC__)
+            static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+            if (hasAvx2) {
+                return classifyAvx2(bytes);
+            }
+#endif
+            return classifyPortable(bytes);
+        }
+
+        // Bytes preceded by an unpaired backslash; only runs on blocks with escapes
+        std::uint64_t escapedPositions(const char* bytes) {
+            std::uint64_t escaped = 0;
+            bool escape = escapeCarry_;
+            for (std::size_t i = 0; i < kBlock; ++i) {
+                if (escape) {
+                    escaped |= std::uint64_t(1) << i;
+                    escape = false;
+                } else if (bytes[i] == '\\') {
+                    escape = true;
+                }
+            }
+            escapeCarry_ = escape;
+            return escaped;
+        }
+    };
+
+    // Input read per call by parseStream
+    static constexpr std::size_t kStreamChunk = std::size_t(1) << 16;
+
+    // One top-level member: either "keys" or a share
+    template <typename Handler>
+    static void parseMember(Cursor& cursor, Handler& handler, bool& sawKeys) {
+        std::string_view key = cursor.readString();
+        cursor.expect(':');
+        if (key == "keys") {
+            Keys keys = parseKeys(cursor);
+            if (keys.n.empty() || keys.k.empty()) {
+                cursor.fail("\"keys\" needs both \"n\" and \"k\"");
+            }
+            handler.keys(keys);
+            sawKeys = true;
+        } else {
+            handler.share(parseShare(cursor, key));
+        }
+    }
+
+    // "keys": {"n": 4, "k": 3}
+    static Keys parseKeys(Cursor& cursor) {
+        Keys keys;
+        cursor.expect('{');
+        if (cursor.consumeIf('}')) {
+            return keys;
+        }
+        do {
+            std::string_view name = cursor.readString();
+            cursor.expect(':');
+            if (name == "n") {
+                keys.n = cursor.readScalar();
+            } else if (name == "k") {
+                keys.k = cursor.readScalar();
+            } else {
+                cursor.skipValue();
+            }
+        } while (cursor.consumeIf(','));
+        cursor.expect('}');
+        return keys;
+    }
+
+    // "1": {"base": "10", "value": "4"}
+    static ShareEntry parseShare(Cursor& cursor, std::string_view index) {
+        ShareEntry share{index, {}, {}};
+        cursor.expect('{');
+        if (!cursor.consumeIf('}')) {
+            do {
+                std::string_view name = cursor.readString();
+                cursor.expect(':');
+                if (name == "base") {
+                    share.base = cursor.readScalar();
+                } else if (name == "value") {
+                    share.value = cursor.readScalar();
+                } else {
+                    cursor.skipValue();
+                }
+            } while (cursor.consumeIf(','));
+            cursor.expect('}');
+        }
+        if (share.base.empty() || share.value.empty()) {
+            cursor.fail("share \"" + std::string(index) + "\" needs both \"base\" and \"value\"");
+        }
+        return share;
+    }
+};
+
+/**
+ * Exact Lagrange interpolation at x = 0
+ *
+ *   f(0) = Σ y_i · Π_{j≠i} x_j / (x_j - x_i)
+ *
+ * Every basis fraction is scaled to one common denominator D, which turns the
+ * basis values into integer weights w_i. Reconstruction is then a dot product
+ * plus a single exact division:
+ *
+ *   f(0) = (Σ w_i · y_i) / D
+ *
+ * Weights depend only on the x-coordinates. No floating point is involved.
+ * Interpolating at another point t is the same problem on the shifted
+ * coordinates x_i - t.
+ */
+class LagrangeInterpolator {
+public:
+    /**
+     * Integer Lagrange weights for one set of x-coordinates
+     * numerators[i] lines up with the i-th x; denominator is always positive
+     */
+    struct Weights {
+        std::vector<BigInt> numerators;
+        BigInt denominator;
+    };
+
+    /**
+     * Computes w_i = D · Π_{j≠i} x_j / Π_{j≠i} (x_j - x_i)
+     *
+     * When every x fits in 64 bits (the normal case: x is the share index),
+     * D is built from the distinct pairwise distances without any big gcds,
+     * and products of small factors are packed into whole limbs first. That
+     * keeps k in the thousands cheap. Larger x-coordinates fall back to an
+     * lcm over BigInt.
+     */
+    static Weights computeWeights(const std::vector<BigInt>& xs) {
+        if (xs.empty()) {
+            throw std::invalid_argument("Cannot interpolate without points");
+        }
+        bool allFit = std::all_of(xs.begin(), xs.end(), [](const BigInt& x) { return x.fitsInt64(); });
+        return allFit ? computeWeightsInt64(xs) : computeWeightsGeneric(xs);
+    }
+
+    /**
+     * Σ w_i · y_i, i.e. D · f(0)
+     */
+    static BigInt weightedSum(const Weights& weights, const std::vector<BigInt>& ys) {
+        if (ys.size() != weights.numerators.size()) {
+            throw std::invalid_argument("Expected " + std::to_string(weights.numerators.size()) +
+                                        " y-values, got " + std::to_string(ys.size()));
+        }
+        BigInt sum;
+        for (std::size_t i = 0; i < ys.size(); ++i) {
+            sum += weights.numerators[i] * ys[i];
+        }
+        return sum;
+    }
+
+    /**
+     * Applies precomputed weights to a set of y-values
+     * Throws if the shares do not interpolate to an integer constant.
+     */
+    static BigInt evaluateAtZero(const Weights& weights, const std::vector<BigInt>& ys) {
+        BigInt sum = weightedSum(weights, ys);
+        BigInt quotient, remainder;
+        BigInt::divMod(sum, weights.denominator, quotient, remainder);
+        if (!remainder.isZero()) {
+            throw std::runtime_error("Shares do not interpolate to an integer constant: f(0) = " +
+                                     sum.toString() + "/" + weights.denominator.toString());
+        }
+        return quotient;
+    }
+
+    static BigInt interpolateAtZero(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys) {
+        return evaluateAtZero(computeWeights(xs), ys);
+    }
+
+    /**
+     * Just D, a positive common multiple of every |Π_{j≠i} (x_j - x_i)|,
+     * without the numerators; the same D computeWeights uses
+     * Throws std::invalid_argument on a duplicate x.
+     */
+    static BigInt commonDenominator(const std::vector<BigInt>& xs) {
+        if (xs.empty()) {
+            throw std::invalid_argument("Cannot interpolate without points");
+        }
+        if (std::all_of(xs.begin(), xs.end(), [](const BigInt& x) { return x.fitsInt64(); })) {
+            std::vector<long long> sorted;
+            sorted.reserve(xs.size());
+            for (const BigInt& x : xs) {
+                sorted.push_back(x.toInt64());
+            }
+            std::sort(sorted.begin(), sorted.end());
+            return commonDenominatorInt64(sorted);
+        }
+        return computeWeightsGeneric(xs).denominator;
+    }
+
+    /**
+     * g'(x_i) = Π_{j≠i} (x_i - x_j) for every i, signed; word-packed when
+     * every x fits in 64 bits
+     */
+    static std::vector<BigInt> basisDenominators(const std::vector<BigInt>& xs) {
+        const std::size_t k = xs.size();
+        const bool allFit = std::all_of(xs.begin(), xs.end(), [](const BigInt& x) { return x.fitsInt64(); });
+        std::vector<BigInt> products;
+        products.reserve(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            if (allFit) {
+                const long long xi = xs[i].toInt64();
+                WordProduct product;
+                bool negative = false;
+                for (std::size_t j = 0; j < k; ++j) {
+                    const long long xj = xs[j].toInt64();
+                    if (j != i) {
+                        product.multiply(xi > xj ? static_cast<std::uint64_t>(xi) - static_cast<std::uint64_t>(xj)
+                                                 : static_cast<std::uint64_t>(xj) - static_cast<std::uint64_t>(xi));
+                        negative ^= xi < xj;
+                    }
+                }
+                BigInt value = product.finish();
+                products.push_back(negative ? -value : value);
+            } else {
+                BigInt value(1);
+                for (std::size_t j = 0; j < k; ++j) {
+                    if (j != i) {
+                        value *= xs[i] - xs[j];
+                    }
+                }
+                products.push_back(std::move(value));
+            }
+        }
+        return products;
+    }
+
+private:
+    friend class OnlineLagrangeInterpolator;
+
+    /**
+     * Multiplies many word-sized factors into a BigInt
+     * Factors are packed into one 64-bit word until it would overflow, so the
+     * BigInt sees one limb multiply per packed word.
+     */
+    class WordProduct {
+    public:
+        void multiply(std::uint64_t factor) {
+            BigInt::DoubleLimb packed = static_cast<BigInt::DoubleLimb>(pending_) * factor;
+            if ((packed >> BigInt::kLimbBits) != 0) {
+                value_.mulAddSmall(pending_, 0);
+                pending_ = factor;
+            } else {
+                pending_ = static_cast<std::uint64_t>(packed);
+            }
+        }
+
+        BigInt finish() {
+            value_.mulAddSmall(pending_, 0);
+            pending_ = 1;
+            return std::move(value_);
+        }
+
+    private:
+        BigInt value_ = BigInt(1);
+        std::uint64_t pending_ = 1;
+    };
+
+    static std::uint64_t magnitude(long long value) {
+        return value < 0 ? std::uint64_t(0) - static_cast<std::uint64_t>(value)
+                         : static_cast<std::uint64_t>(value);
+    }
+
+    /**
+     * 64-bit x-coordinates
+     *
+     * |Π_{j≠i}(x_j - x_i)| is a product of distances δ = |x_j - x_i|. A given δ
+     * occurs at most twice in one product (at x_i - δ and x_i + δ), and twice
+     * only when x_i is the middle of a three-term progression. So
+     *
+     *   D = Π_δ δ^{m(δ)},  m(δ) = 2 if some x_i ± δ are both present, else 1
+     *
+     * is a common multiple of all basis denominators, found with hashing
+     * instead of BigInt gcds.
+     */
+    static Weights computeWeightsInt64(const std::vector<BigInt>& xs) {
+        const std::size_t k = xs.size();
+        std::vector<long long> x(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            x[i] = xs[i].toInt64();
+        }
+
+        std::vector<long long> sorted(x);
+        std::sort(sorted.begin(), sorted.end());
+        Weights weights;
+        weights.denominator = commonDenominatorInt64(sorted);
+        weights.numerators.reserve(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            WordProduct numerator;
+            WordProduct denominator;
+            bool negative = false;
+            for (std::size_t j = 0; j < k; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                numerator.multiply(magnitude(x[j]));
+                negative ^= x[j] < 0;
+                // x_j - x_i is negative exactly when x_j < x_i
+                std::uint64_t distance = x[j] > x[i]
+                    ? static_cast<std::uint64_t>(x[j]) - static_cast<std::uint64_t>(x[i])
+                    : static_cast<std::uint64_t>(x[i]) - static_cast<std::uint64_t>(x[j]);
+                denominator.multiply(distance);
+                negative ^= x[j] < x[i];
+            }
+            BigInt weight = numerator.finish() * (weights.denominator / denominator.finish());
+            weights.numerators.push_back(negative ? -weight : weight);
+        }
+        return weights;
+    }
+
+    // D = Π_δ δ^{m(δ)} over the sorted x-coordinates
+    static BigInt commonDenominatorInt64(const std::vector<long long>& sorted) {
+        const std::size_t k = sorted.size();
+        for (std::size_t i = 1; i < k; ++i) {
+            if (sorted[i] == sorted[i - 1]) {
+                throw std::invalid_argument("Duplicate x-coordinate: " + std::to_string(sorted[i]));
+            }
+        }
+
+        // Distinct distances and whether each one is needed squared
+        std::map<std::uint64_t, int> multiplicity;
+        for (std::size_t i = 0; i < k; ++i) {
+            for (std::size_t j = i + 1; j < k; ++j) {
+                std::uint64_t delta = static_cast<std::uint64_t>(sorted[j]) - static_cast<std::uint64_t>(sorted[i]);
+                int& m = multiplicity[delta];
+                if (m < 2) {
+                    // sorted[i] is the middle of sorted[i] - δ, sorted[i], sorted[j]
+                    bool below = static_cast<std::uint64_t>(sorted[i]) - static_cast<std::uint64_t>(sorted[0]) >= delta &&
+                                 std::binary_search(sorted.begin(), sorted.begin() + static_cast<long>(i),
+                                                    static_cast<long long>(static_cast<std::uint64_t>(sorted[i]) - delta));
+                    m = below ? 2 : std::max(m, 1);
+                }
+            }
+        }
+
+        WordProduct commonDenominator;
+        for (const auto& entry : multiplicity) {
+            for (int r = 0; r < entry.second; ++r) {
+                commonDenominator.multiply(entry.first);
+            }
+        }
+        return commonDenominator.finish();
+    }
+
+    /**
+     * Arbitrary x-coordinates: D is the lcm of the basis denominators
+     */
+    static Weights computeWeightsGeneric(const std::vector<BigInt>& xs) {
+        const std::size_t k = xs.size();
+        std::vector<BigInt> basisNumerators(k);
+        std::vector<BigInt> basisDenominators(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            BigInt numerator(1);
+            BigInt denominator(1);
+            for (std::size_t j = 0; j < k; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                BigInt difference = xs[j] - xs[i];
+                if (difference.isZero()) {
+                    throw std::invalid_argument("Duplicate x-coordinate: " + xs[i].toString());
+                }
+                numerator *= xs[j];
+                denominator *= difference;
+            }
+            // Keep denominators positive so the common denominator is too
+            if (denominator.isNegative()) {
+                numerator = -numerator;
+                denominator = -denominator;
+            }
+            basisNumerators[i] = std::move(numerator);
+            basisDenominators[i] = std::move(denominator);
+        }
+
+        Weights weights;
+        weights.denominator = BigInt(1);
+        for (const BigInt& denominator : basisDenominators) {
+            BigInt divisor = BigInt::gcd(weights.denominator, denominator);
+            weights.denominator = weights.denominator / divisor * denominator;
+        }
+
+        weights.numerators.reserve(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            weights.numerators.push_back(basisNumerators[i] * (weights.denominator / basisDenominators[i]));
+        }
+        return weights;
+    }
+};
+
+/**
+ * Montgomery arithmetic modulo an odd prime p of at most 64·N bits
+ *
+ * Elements are fixed arrays of N limbs holding a·R mod p with R = 2^(64·N).
+ * Multiplication is the CIOS (coarsely integrated operand scanning)
+ * Montgomery product, so reducing a product costs N^2 limb multiplies and
+ * never divides.
+ */
+template <std::size_t N>
+class MontgomeryField {
+public:
+    using Limb = BigInt::Limb;
+    using DoubleLimb = BigInt::DoubleLimb;
+    using Element = std::array<Limb, N>;
+    static constexpr std::size_t kLimbs = N;
+
+    explicit MontgomeryField(const BigInt& prime) : modulus_(prime) {
+        if (prime.isNegative() || prime.bitLength() < 2 || prime.bitLength() > 64 * N ||
+            (prime.limbs()[0] & 1) == 0) {
+            throw std::invalid_argument("Montgomery modulus must be an odd prime of at most " +
+                                        std::to_string(64 * N) + " bits: " + prime.toString());
+        }
+        p_ = toLimbs(prime);
+
+        // -p^{-1} mod 2^64 by Newton iteration (each step doubles the correct bits)
+        Limb inverse = 1;
+        for (int i = 0; i < 6; ++i) {
+            inverse *= 2 - p_[0] * inverse;
+        }
+        pNegInv_ = Limb(0) - inverse;
+
+        BigInt r = BigInt(1) << (64 * N);
+        one_ = toLimbs(r % prime);
+        r2_ = toLimbs((r * r) % prime);
+    }
+
+    const BigInt& modulus() const { return modulus_; }
+
+    Element zero() const { return Element{}; }
+    Element one() const { return one_; }
+
+    bool isZero(const Element& a) const {
+        for (Limb limb : a) {
+            if (limb != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool equal(const Element& a, const Element& b) const { return a == b; }
+
+    // Reduces any integer (negative included) into Montgomery form
+    Element fromBigInt(const BigInt& value) const {
+        BigInt reduced = value % modulus_;
+        if (reduced.isNegative()) {
+            reduced += modulus_;
+        }
+        return mul(toLimbs(reduced), r2_);
+    }
+
+    Element fromUint64(std::uint64_t value) const {
+        Element raw{};
+        raw[0] = value;
+        if (N == 1 && value >= p_[0]) {
+            raw[0] = value % p_[0];
+        }
+        return mul(raw, r2_);
+    }
+
+    BigInt toBigInt(const Element& a) const {
+        Element raw{};
+        raw[0] = 1;
+        Element plain = mul(a, raw);
+        return BigInt::fromLimbs(plain.data(), N);
+    }
+
+    Element add(const Element& a, const Element& b) const {
+        Element sum;
+        Limb carry = 0;
+        #pragma GCC unroll 8
+        for (std::size_t i = 0; i < N; ++i) {
+            DoubleLimb t = static_cast<DoubleLimb>(a[i]) + b[i] + carry;
+            sum[i] = static_cast<Limb>(t);
+            carry = static_cast<Limb>(t >> 64);
+        }
+        if (carry != 0 || !lessThanModulus(sum)) {
+            subtractModulus(sum);
+        }
+        return sum;
+    }
+
+    Element sub(const Element& a, const Element& b) const {
+        Element difference;
+        Limb borrow = 0;
+        #pragma GCC unroll 8
+        for (std::size_t i = 0; i < N; ++i) {
+            DoubleLimb t = static_cast<DoubleLimb>(a[i]) - b[i] - borrow;
+            difference[i] = static_cast<Limb>(t);
+            borrow = static_cast<Limb>(t >> 64) & 1;
+        }
+        if (borrow != 0) {
+            Limb carry = 0;
+            #pragma GCC unroll 8
+            for (std::size_t i = 0; i < N; ++i) {
+                DoubleLimb t = static_cast<DoubleLimb>(difference[i]) + p_[i] + carry;
+                difference[i] = static_cast<Limb>(t);
+                carry = static_cast<Limb>(t >> 64);
+            }
+        }
+        return difference;
+    }
+
+    Element neg(const Element& a) const { return sub(zero(), a); }
+
+    /**
+     * Montgomery product a·b·R^{-1} mod p (CIOS)
+     */
+    Element mul(const Element& a, const Element& b) const {
+        Limb t[N + 2] = {};
+        #pragma GCC unroll 8
+        for (std::size_t i = 0; i < N; ++i) {
+            // t += a · b[i]
+            Limb carry = 0;
+            #pragma GCC unroll 8
+            for (std::size_t j = 0; j < N; ++j) {
+                DoubleLimb product = static_cast<DoubleLimb>(a[j]) * b[i] + t[j] + carry;
+                t[j] = static_cast<Limb>(product);
+                carry = static_cast<Limb>(product >> 64);
+            }
+            DoubleLimb top = static_cast<DoubleLimb>(t[N]) + carry;
+            t[N] = static_cast<Limb>(top);
+            t[N + 1] = static_cast<Limb>(top >> 64);
+
+            // t = (t + m·p) / 2^64 with m chosen so the low limb cancels
+            Limb m = t[0] * pNegInv_;
+            DoubleLimb reduced = static_cast<DoubleLimb>(m) * p_[0] + t[0];
+            carry = static_cast<Limb>(reduced >> 64);
+            #pragma GCC unroll 8
+            for (std::size_t j = 1; j < N; ++j) {
+                reduced = static_cast<DoubleLimb>(m) * p_[j] + t[j] + carry;
+                t[j - 1] = static_cast<Limb>(reduced);
+                carry = static_cast<Limb>(reduced >> 64);
+            }
+            top = static_cast<DoubleLimb>(t[N]) + carry;
+            t[N - 1] = static_cast<Limb>(top);
+            t[N] = t[N + 1] + static_cast<Limb>(top >> 64);
+        }
+
+        Element result;
+        #pragma GCC unroll 8
+        for (std::size_t i = 0; i < N; ++i) {
+            result[i] = t[i];
+        }
+        if (t[N] != 0 || !lessThanModulus(result)) {
+            subtractModulus(result);
+        }
+        return result;
+    }
+
+    /**
+     * Σ a_i · b_i
+     *
+     * For one-limb primes the products are summed as plain 128-bit
+     * integers, with a count of the 2^128 carries, and reduced once at the
+     * end: a 64×64 multiply and a 128-bit add per term instead of a
+     * Montgomery reduction and a modular add. Two accumulators keep
+     * consecutive multiplies independent. Wider primes take the mul/add
+     * loop.
+     */
+    Element dot(const Element* a, const Element* b, std::size_t n) const {
+        if constexpr (N == 1) {
+            DoubleLimb sums[2] = {0, 0};
+            Limb carries = 0;
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                #pragma GCC unroll 2
+                for (std::size_t lane = 0; lane < 2; ++lane) {
+                    const DoubleLimb product = static_cast<DoubleLimb>(a[i + lane][0]) * b[i + lane][0];
+                    sums[lane] += product;
+                    carries += sums[lane] < product;
+                }
+            }
+            for (; i < n; ++i) {
+                const DoubleLimb product = static_cast<DoubleLimb>(a[i][0]) * b[i][0];
+                sums[0] += product;
+                carries += sums[0] < product;
+            }
+            const DoubleLimb sum = sums[0] + sums[1];
+            carries += sum < sums[0];
+
+            // Σ = carries·2^128 + hi·2^64 + lo, and R = 2^64
+            const Limb hi = static_cast<Limb>(sum >> 64) % p_[0];
+            const Limb lo = static_cast<Limb>(sum);
+            // (hi·2^64 + lo) / R: hi < p keeps the single-limb reduction below 2p
+            const Limb m = lo * pNegInv_;
+            DoubleLimb reduced = static_cast<DoubleLimb>(hi) + (lo != 0) +
+                                 static_cast<Limb>((static_cast<DoubleLimb>(m) * p_[0]) >> 64);
+            if (reduced >= p_[0]) {
+                reduced -= p_[0];
+            }
+            Element result{static_cast<Limb>(reduced)};
+            // carries·2^128 / R = carries·R, carries in Montgomery form
+            return carries == 0 ? result : add(result, fromUint64(carries));
+        } else {
+            Element sum = zero();
+            for (std::size_t i = 0; i < n; ++i) {
+                sum = add(sum, mul(a[i], b[i]));
+            }
+            return sum;
+        }
+    }
+
+    Element pow(Element base, const BigInt& exponent) const {
+        Element result = one_;
+        for (std::size_t bit = 0; bit < exponent.bitLength(); ++bit) {
+            if (exponent.testBit(bit)) {
+                result = mul(result, base);
+            }
+            base = mul(base, base);
+        }
+        return result;
+    }
+
+    // Fermat inverse a^(p-2); p must be prime
+    Element inverse(const Element& a) const {
+        if (isZero(a)) {
+            throw std::domain_error("Zero has no inverse modulo " + modulus_.toString());
+        }
+        return pow(a, modulus_ - BigInt(2));
+    }
+
+    /**
+     * Miller-Rabin with the first twelve prime bases
+     * Deterministic below 3.3·10^24 and a vanishing error rate above.
+     */
+    bool isProbablePrime() const {
+        static const unsigned kBases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+        if (modulus_ <= BigInt(37)) {
+            for (unsigned base : kBases) {
+                if (modulus_ == BigInt(base)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        BigInt d = modulus_ - BigInt(1);
+        std::size_t twos = 0;
+        while (!d.testBit(0)) {
+            d >>= 1;
+            ++twos;
+        }
+        const Element minusOne = neg(one_);
+        for (unsigned base : kBases) {
+            Element x = pow(fromUint64(base), d);
+            if (equal(x, one_) || equal(x, minusOne)) {
+                continue;
+            }
+            bool witness = true;
+            for (std::size_t r = 1; r < twos && witness; ++r) {
+                x = mul(x, x);
+                witness = !equal(x, minusOne);
+            }
+            if (witness) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    BigInt modulus_;
+    Element p_{};
+    Limb pNegInv_ = 0;
+    Element one_{};  // R mod p
+    Element r2_{};   // R^2 mod p, converts into Montgomery form
+
+    static Element toLimbs(const BigInt& value) {
+        Element limbs{};
+        for (std::size_t i = 0; i < value.limbCount() && i < N; ++i) {
+            limbs[i] = value.limbs()[i];
+        }
+        return limbs;
+    }
+
+    bool lessThanModulus(const Element& a) const {
+        for (std::size_t i = N; i-- > 0;) {
+            if (a[i] != p_[i]) {
+                return a[i] < p_[i];
+            }
+        }
+        return false;
+    }
+
+    void subtractModulus(Element& a) const {
+        Limb borrow = 0;
+        #pragma GCC unroll 8
+        for (std::size_t i = 0; i < N; ++i) {
+            DoubleLimb t = static_cast<DoubleLimb>(a[i]) - p_[i] - borrow;
+            a[i] = static_cast<Limb>(t);
+            borrow = static_cast<Limb>(t >> 64) & 1;
+        }
+    }
+};
+
+/**
+ * Runs visitor(field) with the smallest Montgomery field that holds the prime
+ * Supports primes up to 512 bits.
+ */
+template <typename Visitor>
+auto withMontgomeryField(const BigInt& prime, Visitor&& visitor) {
+    const std::size_t bits = prime.bitLength();
+    if (bits <= 64) {
+        return visitor(MontgomeryField<1>(prime));
+    } else if (bits <= 128) {
+        return visitor(MontgomeryField<2>(prime));
+    } else if (bits <= 256) {
+        return visitor(MontgomeryField<4>(prime));
+    } else if (bits <= 512) {
+        return visitor(MontgomeryField<8>(prime));
+    }
+    throw std::invalid_argument("Prime field modulus is limited to 512 bits, got " + std::to_string(bits));
+}
+
+/**
+ * Montgomery arithmetic modulo an odd prime below 2^30, one 32-bit word
+ * per element
+ *
+ * The same interface as MontgomeryField<N>, for the small NTT primes: a
+ * product of two elements fits a 64-bit lane, so AVX2 can run eight
+ * Montgomery products side by side. Elements hold a·2^32 mod p.
+ */
+class MontgomeryField32 {
+public:
+    using Element = std::uint32_t;
+    static constexpr std::size_t kLimbs = 1;
+
+    explicit MontgomeryField32(std::uint32_t prime) : modulus_(prime), p_(prime) {
+        if (prime < 3 || prime >= (1u << 30) || (prime & 1) == 0) {
+            throw std::invalid_argument("32-bit Montgomery modulus must be an odd prime below 2^30: " +
+                                        std::to_string(prime));
+        }
+        std::uint32_t inverse = 1;
+        for (int i = 0; i < 5; ++i) {
+            inverse *= 2 - prime * inverse;
+        }
+        pNegInv_ = 0u - inverse;
+        one_ = static_cast<Element>((std::uint64_t(1) << 32) % prime);
+        r2_ = static_cast<Element>(static_cast<std::uint64_t>(one_) * one_ % prime);
+    }
+
+    const BigInt& modulus() const { return modulus_; }
+    std::uint32_t prime() const { return p_; }
+    // -p^{-1} mod 2^32
+    std::uint32_t negInverse() const { return pNegInv_; }
+
+    Element zero() const { return 0; }
+    Element one() const { return one_; }
+    bool isZero(Element a) const { return a == 0; }
+    bool equal(Element a, Element b) const { return a == b; }
+
+    Element fromUint64(std::uint64_t value) const { return mul(static_cast<Element>(value % p_), r2_); }
+
+    Element fromBigInt(const BigInt& value) const {
+        std::uint64_t residue = 0;
+        for (std::size_t i = value.limbCount(); i-- > 0;) {
+            residue = static_cast<std::uint64_t>(((static_cast<BigInt::DoubleLimb>(residue) << 64) | value.limbs()[i]) % p_);
+        }
+        const Element a = fromUint64(residue);
+        return value.isNegative() ? neg(a) : a;
+    }
+
+    // Canonical residue in [0, p)
+    std::uint32_t toUint32(Element a) const { return reduce(a); }
+    BigInt toBigInt(Element a) const { return BigInt(toUint32(a)); }
+
+    Element add(Element a, Element b) const {
+        const Element sum = a + b;
+        return sum >= p_ ? sum - p_ : sum;
+    }
+    Element sub(Element a, Element b) const { return a >= b ? a - b : a + p_ - b; }
+    Element neg(Element a) const { return a == 0 ? 0 : p_ - a; }
+    Element mul(Element a, Element b) const { return reduce(static_cast<std::uint64_t>(a) * b); }
+
+    /**
+     * Σ a_i · b_i, with every product summed unreduced
+     * Products stay below 2^60, so AVX2 adds eight per step into 64-bit
+     * lanes and flushes the lanes into a 128-bit total every eight steps,
+     * before any lane can overflow; the total is reduced modulo p once.
+     */
+    Element dot(const Element* a, const Element* b, std::size_t n) const {
+        unsigned __int128 sum = 0;
+        std::size_t i = 0;
+#if defined(__x86_64__) && defined(__GNUC__)
+        static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+        if (hasAvx2) {
+            i = n / 8 * 8;
+            sum = dotAvx2(a, b, i);
+        }
+#endif
+        for (; i < n; ++i) {
+            sum += static_cast<std::uint64_t>(a[i]) * b[i];
+        }
+        // Σ (a·2^32)(b·2^32) = 2^64·Σab, so one reduction leaves 2^32·Σab
+        return reduce(static_cast<std::uint64_t>(sum % p_));
+    }
+
+    Element pow(Element base, const BigInt& exponent) const {
+        Element result = one_;
+        for (std::size_t bit = 0; bit < exponent.bitLength(); ++bit) {
+            if (exponent.testBit(bit)) {
+                result = mul(result, base);
+            }
+            base = mul(base, base);
+        }
+        return result;
+    }
+
+    Element inverse(Element a) const {
+        if (a == 0) {
+            throw std::domain_error("Zero has no inverse modulo " + std::to_string(p_));
+        }
+        return pow(a, BigInt(p_ - 2));
+    }
+
+    bool isProbablePrime() const { return MontgomeryField<1>(modulus_).isProbablePrime(); }
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    // Eight lanes at a time, with p and -p^{-1} broadcast and every lane below p
+
+    // Montgomery products a·b·2^-32 mod p, fully reduced
+    __attribute__((target("avx2"))) static __m256i mulAvx2(__m256i a, __m256i b, __m256i p, __m256i pNegInv) {
+        const __m256i even = _mm256_mul_epu32(a, b);
+        const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        const __m256i evenSum = _mm256_add_epi64(even, _mm256_mul_epu32(_mm256_mul_epu32(even, pNegInv), p));
+        const __m256i oddSum = _mm256_add_epi64(odd, _mm256_mul_epu32(_mm256_mul_epu32(odd, pNegInv), p));
+        // Each sum is a multiple of 2^32 whose high word is the product, below 2p
+        const __m256i product = _mm256_blend_epi32(_mm256_srli_epi64(evenSum, 32), oddSum, 0xAA);
+        return _mm256_min_epu32(product, _mm256_sub_epi32(product, p));
+    }
+
+    __attribute__((target("avx2"))) static __m256i addAvx2(__m256i a, __m256i b, __m256i p) {
+        const __m256i sum = _mm256_add_epi32(a, b);
+        return _mm256_min_epu32(sum, _mm256_sub_epi32(sum, p));
+    }
+
+    __attribute__((target("avx2"))) static __m256i subAvx2(__m256i a, __m256i b, __m256i p) {
+        const __m256i difference = _mm256_sub_epi32(a, b);
+        return _mm256_min_epu32(difference, _mm256_add_epi32(difference, p));
+    }
+#endif
+
+private:
+    BigInt modulus_;
+    std::uint32_t p_;
+    std::uint32_t pNegInv_;
+    Element one_;
+    Element r2_;
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    // n is a multiple of 8
+    __attribute__((target("avx2")))
+    static unsigned __int128 dotAvx2(const std::uint32_t* a, const std::uint32_t* b, std::size_t n) {
+        unsigned __int128 total = 0;
+        for (std::size_t block = 0; block < n; block += 64) {
+            __m256i even = _mm256_setzero_si256(), odd = _mm256_setzero_si256();
+            const std::size_t end = std::min(block + 64, n);
+            for (std::size_t i = block; i < end; i += 8) {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                even = _mm256_add_epi64(even, _mm256_mul_epu32(x, y));
+                odd = _mm256_add_epi64(odd, _mm256_mul_epu32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32)));
+            }
+            alignas(32) std::uint64_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), even);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes + 4), odd);
+            for (std::uint64_t lane : lanes) {
+                total += lane;
+            }
+        }
+        return total;
+    }
+#endif
+
+    // t·2^-32 mod p for t < p·2^32
+    Element reduce(std::uint64_t t) const {
+        const std::uint32_t m = static_cast<std::uint32_t>(t) * pNegInv_;
+        const Element u = static_cast<Element>((t + static_cast<std::uint64_t>(m) * p_) >> 32);
+        return u >= p_ ? u - p_ : u;
+    }
+};
+
+/**
+ * Lagrange interpolation at x = 0 over a prime field
+ *
+ *   f(0) = Σ y_i · λ_i,  λ_i = Π_{j≠i} x_j / Π_{j≠i} (x_j - x_i)  (mod p)
+ *
+ * Numerators come from prefix/suffix products of the x_j. All k
+ * denominators are inverted together with Montgomery's trick, so a
+ * reconstruction costs O(k^2) field multiplies and exactly one inversion.
+ */
+template <typename Field>
+class FieldLagrangeInterpolator {
+public:
+    using Element = typename Field::Element;
+
+    /**
+     * Replaces every value by its inverse using a single field inversion
+     * prefix_i = v_0···v_i; inverting prefix_{k-1} and walking backwards
+     * peels off one inverse per step.
+     */
+    static void batchInvert(const Field& field, std::vector<Element>& values) {
+        if (values.empty()) {
+            return;
+        }
+        std::vector<Element> prefix(values.size());
+        prefix[0] = values[0];
+        for (std::size_t i = 1; i < values.size(); ++i) {
+            prefix[i] = field.mul(prefix[i - 1], values[i]);
+        }
+        if (field.isZero(prefix.back())) {
+            throw std::domain_error("Cannot batch-invert a zero element");
+        }
+
+        Element inverse = field.inverse(prefix.back());
+        for (std::size_t i = values.size() - 1; i > 0; --i) {
+            Element current = field.mul(inverse, prefix[i - 1]);
+            inverse = field.mul(inverse, values[i]);
+            values[i] = current;
+        }
+        values[0] = inverse;
+    }
+
+    /**
+     * λ_i for the given x-coordinates (already reduced into the field)
+     */
+    static std::vector<Element> computeWeights(const Field& field, const std::vector<Element>& xs) {
+        const std::size_t k = xs.size();
+        if (k == 0) {
+            throw std::invalid_argument("Cannot interpolate without points");
+        }
+
+        // Π_{j≠i} x_j = prefix(i) · suffix(i)
+        std::vector<Element> suffix(k + 1);
+        suffix[k] = field.one();
+        for (std::size_t i = k; i-- > 0;) {
+            suffix[i] = field.mul(suffix[i + 1], xs[i]);
+        }
+
+        std::vector<Element> denominators(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            Element product = field.one();
+            for (std::size_t j = 0; j < k; ++j) {
+                if (j != i) {
+                    product = field.mul(product, field.sub(xs[j], xs[i]));
+                }
+            }
+            if (field.isZero(product)) {
+                throw std::invalid_argument("x-coordinates collide modulo " + field.modulus().toString());
+            }
+            denominators[i] = product;
+        }
+        batchInvert(field, denominators);
+
+        std::vector<Element> weights(k);
+        Element prefix = field.one();
+        for (std::size_t i = 0; i < k; ++i) {
+            weights[i] = field.mul(field.mul(prefix, suffix[i + 1]), denominators[i]);
+            prefix = field.mul(prefix, xs[i]);
+        }
+        return weights;
+    }
+
+    /**
+     * λ_i for x-coordinates that fit in 64 bits
+     * Distances |x_j - x_i| are packed into whole words before they enter
+     * the field, so each denominator needs one Montgomery conversion and
+     * multiply per packed word instead of a subtract and multiply per
+     * factor. Signs are tracked outside the field.
+     */
+    static std::vector<Element> computeWeights(const Field& field, const std::vector<long long>& xs) {
+        const std::size_t k = xs.size();
+        if (k == 0) {
+            throw std::invalid_argument("Cannot interpolate without points");
+        }
+
+        std::vector<Element> fieldXs(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            fieldXs[i] = fromInt64(field, xs[i]);
+        }
+        std::vector<Element> suffix(k + 1);
+        suffix[k] = field.one();
+        for (std::size_t i = k; i-- > 0;) {
+            suffix[i] = field.mul(suffix[i + 1], fieldXs[i]);
+        }
+
+        std::vector<Element> denominators(k);
+        std::vector<bool> negative(k);
+        for (std::size_t i = 0; i < k; ++i) {
+            Element product = field.one();
+            std::uint64_t packed = 1;
+            bool odd = false;
+            for (std::size_t j = 0; j < k; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                std::uint64_t distance = xs[j] > xs[i]
+                    ? static_cast<std::uint64_t>(xs[j]) - static_cast<std::uint64_t>(xs[i])
+                    : static_cast<std::uint64_t>(xs[i]) - static_cast<std::uint64_t>(xs[j]);
+                odd ^= xs[j] < xs[i];
+                BigInt::DoubleLimb wide = static_cast<BigInt::DoubleLimb>(packed) * distance;
+                if ((wide >> 64) != 0) {
+                    product = field.mul(product, field.fromUint64(packed));
+                    packed = distance;
+                } else {
+                    packed = static_cast<std::uint64_t>(wide);
+                }
+            }
+            product = field.mul(product, field.fromUint64(packed));
+            if (field.isZero(product)) {
+                throw std::invalid_argument("x-coordinates collide modulo " + field.modulus().toString());
+            }
+            denominators[i] = product;
+            negative[i] = odd;
+        }
+        batchInvert(field, denominators);
+
+        std::vector<Element> weights(k);
+        Element prefix = field.one();
+        for (std::size_t i = 0; i < k; ++i) {
+            Element weight = field.mul(field.mul(prefix, suffix[i + 1]), denominators[i]);
+            weights[i] = negative[i] ? field.neg(weight) : weight;
+            prefix = field.mul(prefix, fieldXs[i]);
+        }
+        return weights;
+    }
+
+    static Element fromInt64(const Field& field, long long value) {
+        Element magnitude = field.fromUint64(value < 0 ? std::uint64_t(0) - static_cast<std::uint64_t>(value)
+                                                       : static_cast<std::uint64_t>(value));
+        return value < 0 ? field.neg(magnitude) : magnitude;
+    }
+
+    // Σ λ_i · y_i through the field's lazily reduced kernel
+    static Element dot(const Field& field, const std::vector<Element>& weights, const std::vector<Element>& ys) {
+        return field.dot(weights.data(), ys.data(), weights.size());
+    }
+
+    static Element interpolateAtZero(const Field& field, const std::vector<Element>& xs,
+                                     const std::vector<Element>& ys) {
+        return dot(field, computeWeights(field, xs), ys);
+    }
+};
+
+/**
+ * Lagrange weights kept per set of x-coordinates, least recently used
+ * evicted first
+ *
+ * Weights depend only on the x's (and the modulus), and in practice shares
+ * keep arriving at the same few index sets, so a repeat reconstruction is
+ * just the dot product. Entries are keyed by the modulus (zero for exact
+ * integer weights) and the sorted x's; field weights are stored reduced,
+ * as numerators over a denominator of 1. Lookups from several threads are
+ * safe. Weights are computed outside the lock, so two threads missing on
+ * the same set at once both compute it.
+ *
+ * save() and load() keep the cache in a text file between runs: one entry
+ * per line, every number in hex, least recently used first.
+ */
+class LagrangeWeightsCache {
+public:
+    using Weights = LagrangeInterpolator::Weights;
+
+    explicit LagrangeWeightsCache(std::size_t capacity = 256) : capacity_(std::max<std::size_t>(capacity, 1)) {}
+
+    /**
+     * Weights lined up with xs, from the cache or from compute(sortedXs)
+     * compute gets the x's in ascending order and returns weights in that
+     * order.
+     */
+    template <typename Compute>
+    std::shared_ptr<const Weights> get(const BigInt& modulus, const std::vector<BigInt>& xs, Compute&& compute) {
+        std::vector<std::size_t> order(xs.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return xs[a] < xs[b]; });
+        std::vector<BigInt> sorted;
+        sorted.reserve(xs.size());
+        for (std::size_t i : order) {
+            sorted.push_back(xs[i]);
+        }
+        const std::string key = makeKey(modulus, sorted);
+
+        std::shared_ptr<const Weights> weights = find(key);
+        if (weights) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            // Entries outlive any one test case
+            FileArena::Suspend heap;
+            weights = std::make_shared<const Weights>(compute(sorted));
+            insert(key, modulus, sorted, weights);
+        }
+        if (std::is_sorted(order.begin(), order.end())) {
+            return weights;
+        }
+        auto permuted = std::make_shared<Weights>();
+        permuted->denominator = weights->denominator;
+        permuted->numerators.resize(xs.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            permuted->numerators[order[i]] = weights->numerators[i];
+        }
+        return permuted;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> guard(lock_);
+        return entries_.size();
+    }
+
+    std::uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    std::uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+    /**
+     * Adds the entries saved in path; returns false when it cannot be opened
+     * Throws std::runtime_error on a malformed line.
+     */
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            return false;
+        }
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            if (line.empty()) {
+                continue;
+            }
+            try {
+                std::istringstream fields(line);
+                std::string word;
+                auto next = [&]() {
+                    if (!(fields >> word)) {
+                        throw std::invalid_argument("truncated entry");
+                    }
+                    return BigInt::fromString(word, 16);
+                };
+                BigInt modulus = next();
+                BigInt count = next();
+                if (!count.fitsInt64() || count.isNegative() || count > BigInt(1 << 24)) {
+                    throw std::invalid_argument("bad point count");
+                }
+                const auto k = static_cast<std::size_t>(count.toInt64());
+                std::vector<BigInt> xs;
+                auto weights = std::make_shared<Weights>();
+                for (std::size_t i = 0; i < k; ++i) {
+                    xs.push_back(next());
+                }
+                weights->denominator = next();
+                for (std::size_t i = 0; i < k; ++i) {
+                    weights->numerators.push_back(next());
+                }
+                if (fields >> word || !std::is_sorted(xs.begin(), xs.end())) {
+                    throw std::invalid_argument("bad entry");
+                }
+                insert(makeKey(modulus, xs), modulus, xs, std::move(weights));
+            } catch (const std::invalid_argument& e) {
+                throw std::runtime_error("Malformed weights cache " + path + " at line " +
+                                         std::to_string(lineNumber) + ": " + e.what());
+            }
+        }
+        return true;
+    }
+
+    // Throws std::runtime_error when path cannot be written
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot write weights cache: " + path);
+        }
+        std::lock_guard<std::mutex> guard(lock_);
+        for (auto entry = entries_.rbegin(); entry != entries_.rend(); ++entry) {
+            out << entry->modulus.toString(16) << ' ' << std::hex << entry->xs.size() << std::dec;
+            for (const BigInt& x : entry->xs) {
+                out << ' ' << x.toString(16);
+            }
+            out << ' ' << entry->weights->denominator.toString(16);
+            for (const BigInt& weight : entry->weights->numerators) {
+                out << ' ' << weight.toString(16);
+            }
+            out << '\n';
+        }
+        if (!out.flush()) {
+            throw std::runtime_error("Cannot write weights cache: " + path);
+        }
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        BigInt modulus;
+        std::vector<BigInt> xs;
+        std::shared_ptr<const Weights> weights;
+    };
+
+    const std::size_t capacity_;
+    mutable std::mutex lock_;
+    // Most recently used first
+    std::list<Entry> entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+
+    static std::string makeKey(const BigInt& modulus, const std::vector<BigInt>& sorted) {
+        std::string key = modulus.toString(16);
+        for (const BigInt& x : sorted) {
+            key += ',';
+            key += x.toString(16);
+        }
+        return key;
+    }
+
+    std::shared_ptr<const Weights> find(const std::string& key) {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto found = index_.find(key);
+        if (found == index_.end()) {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->weights;
+    }
+
+    void insert(const std::string& key, const BigInt& modulus, const std::vector<BigInt>& sorted,
+                std::shared_ptr<const Weights> weights) {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto found = index_.find(key);
+        if (found != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, found->second);
+            return;
+        }
+        entries_.push_front(Entry{key, modulus, sorted, std::move(weights)});
+        index_.emplace(key, entries_.begin());
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().key);
+            entries_.pop_back();
+        }
+    }
+};
+
+/**
+ * Exact f(0) reconstruction that takes shares one at a time
+ *
+ * Each share keeps its basis fraction Π_{j≠i} x_j / Π_{j≠i} (x_j - x_i) as a
+ * sign and a positive denominator; the numerators all come from one running
+ * product of the x's. A new share multiplies every stored denominator by one
+ * distance and builds its own from the same j distances, so the j-th add
+ * costs O(j) multiplications instead of recomputing all weights. For
+ * 64-bit x the common denominator D = Π_δ δ^{m(δ)} (see
+ * LagrangeInterpolator::computeWeightsInt64) is maintained along the way
+ * from a hash of the points.
+ *
+ * secret() then needs only D / denominator_i per share and one division.
+ */
+class OnlineLagrangeInterpolator {
+public:
+    void add(const BigInt& x, BigInt y) {
+        if (smallXs_ && x.fitsInt64()) {
+            addInt64(x.toInt64());
+        } else {
+            addGeneric(x);
+        }
+        xs_.push_back(x);
+        ys_.push_back(std::move(y));
+    }
+
+    std::size_t size() const { return xs_.size(); }
+    const std::vector<BigInt>& xs() const { return xs_; }
+    const std::vector<BigInt>& ys() const { return ys_; }
+
+    /**
+     * Integer weights for the shares added so far, as computeWeights()
+     * would return them for the same x-coordinates (up to a common factor)
+     */
+    LagrangeInterpolator::Weights weights() const {
+        if (xs_.empty()) {
+            throw std::invalid_argument("Cannot interpolate without points");
+        }
+        LagrangeInterpolator::Weights weights;
+        if (smallXs_) {
+            weights.denominator = commonDenominator_;
+        } else {
+            weights.denominator = BigInt(1);
+            for (const BigInt& denominator : denominators_) {
+                BigInt divisor = BigInt::gcd(weights.denominator, denominator);
+                weights.denominator = weights.denominator / divisor * denominator;
+            }
+        }
+        weights.numerators.reserve(xs_.size());
+        for (std::size_t i = 0; i < xs_.size(); ++i) {
+            BigInt weight = numerator(i) * (weights.denominator / denominators_[i]);
+            weights.numerators.push_back(negative_[i] ? -weight : weight);
+        }
+        return weights;
+    }
+
+    /**
+     * f(0) of the polynomial through the shares added so far
+     * Throws if that value is not an integer.
+     */
+    BigInt secret() const {
+        return LagrangeInterpolator::evaluateAtZero(weights(), ys_);
+    }
+
+private:
+    using WordProduct = LagrangeInterpolator::WordProduct;
+
+    std::vector<BigInt> xs_;
+    std::vector<BigInt> ys_;
+    std::vector<BigInt> numerators_;    // |Π_{j≠i} x_j|, only once x outgrows 64 bits
+    std::vector<BigInt> denominators_;  // |Π_{j≠i} (x_j - x_i)|
+    std::vector<bool> negative_;        // sign of the basis fraction
+
+    // While every x fits in 64 bits
+    bool smallXs_ = true;
+    std::vector<long long> smallXs64_;
+    std::unordered_set<long long> points_;
+    std::unordered_map<std::uint64_t, unsigned char> multiplicity_;
+    BigInt commonDenominator_ = BigInt(1);
+    BigInt xProduct_ = BigInt(1);       // Π |x_j| over the nonzero x_j
+    std::size_t zeroIndex_ = kNoZero;   // share with x = 0, if any
+
+    static constexpr std::size_t kNoZero = std::numeric_limits<std::size_t>::max();
+
+    // |Π_{j≠i} x_j|; in 64-bit mode derived from the running product of all x
+    BigInt numerator(std::size_t i) const {
+        if (!smallXs_) {
+            return numerators_[i];
+        }
+        if (zeroIndex_ != kNoZero) {
+            return i == zeroIndex_ ? xProduct_ : BigInt();
+        }
+        BigInt result = xProduct_;
+        result.divModSmall(LagrangeInterpolator::magnitude(smallXs64_[i]));
+        return result;
+    }
+
+    bool hasPoint(__int128 value) const {
+        return value >= std::numeric_limits<long long>::min() &&
+               value <= std::numeric_limits<long long>::max() &&
+               points_.count(static_cast<long long>(value)) != 0;
+    }
+
+    void addInt64(long long x) {
+        if (points_.count(x) != 0) {
+            throw std::invalid_argument("Duplicate x-coordinate: " + std::to_string(x));
+        }
+
+        WordProduct denominator;
+        WordProduct denominatorGrowth;
+        bool negative = false;
+        for (std::size_t i = 0; i < smallXs64_.size(); ++i) {
+            const long long other = smallXs64_[i];
+            const std::uint64_t distance = x > other
+                ? static_cast<std::uint64_t>(x) - static_cast<std::uint64_t>(other)
+                : static_cast<std::uint64_t>(other) - static_cast<std::uint64_t>(x);
+
+            // Existing fraction gains x / (x - x_i); the x goes into xProduct_
+            denominators_[i].mulAddSmall(distance, 0);
+            negative_[i] = negative_[i] != ((x < 0) != (x < other));
+
+            // New fraction gains x_i / (x_i - x)
+            denominator.multiply(distance);
+            negative ^= (other < 0) != (other < x);
+
+            // δ is needed twice if x or x_i is now the middle of a progression
+            const __int128 wideX = x;
+            const __int128 wideOther = other;
+            const unsigned char needed = hasPoint(2 * wideX - wideOther) ||
+                                         hasPoint(2 * wideOther - wideX) ? 2 : 1;
+            unsigned char& m = multiplicity_[distance];
+            for (; m < needed; ++m) {
+                denominatorGrowth.multiply(distance);
+            }
+        }
+        commonDenominator_ = commonDenominator_ * denominatorGrowth.finish();
+        if (x == 0) {
+            zeroIndex_ = smallXs64_.size();
+        } else {
+            xProduct_.mulAddSmall(LagrangeInterpolator::magnitude(x), 0);
+        }
+
+        denominators_.push_back(denominator.finish());
+        negative_.push_back(negative);
+        smallXs64_.push_back(x);
+        points_.insert(x);
+    }
+
+    void addGeneric(const BigInt& x) {
+        std::vector<BigInt> differences(xs_.size());
+        for (std::size_t i = 0; i < xs_.size(); ++i) {
+            differences[i] = x - xs_[i];
+            if (differences[i].isZero()) {
+                throw std::invalid_argument("Duplicate x-coordinate: " + x.toString());
+            }
+        }
+        // Past 64 bits the common denominator is an lcm, taken in weights()
+        if (smallXs_) {
+            for (std::size_t i = 0; i < xs_.size(); ++i) {
+                numerators_.push_back(numerator(i));
+            }
+        }
+        smallXs_ = false;
+        smallXs64_.clear();
+        points_.clear();
+        multiplicity_.clear();
+
+        const BigInt xMagnitude = x.abs();
+        BigInt numerator(1);
+        BigInt denominator(1);
+        bool negative = false;
+        for (std::size_t i = 0; i < xs_.size(); ++i) {
+            numerators_[i] = numerators_[i] * xMagnitude;
+            denominators_[i] = denominators_[i] * differences[i].abs();
+            negative_[i] = negative_[i] != (x.isNegative() != differences[i].isNegative());
+
+            numerator = numerator * xs_[i].abs();
+            denominator = denominator * differences[i].abs();
+            negative ^= xs_[i].isNegative() != !differences[i].isNegative();
+        }
+        numerators_.push_back(std::move(numerator));
+        denominators_.push_back(std::move(denominator));
+        negative_.push_back(negative);
+    }
+};
+
+/**
+ * f(0) mod p reconstruction that takes shares one at a time
+ *
+ * Keeps the barycentric denominators d_i = Π_{j≠i} (x_j - x_i) in the field.
+ * The j-th add is O(j) multiplications; secret() is O(j) plus one inversion
+ * shared by all shares.
+ */
+template <typename Field>
+class OnlineFieldLagrangeInterpolator {
+public:
+    using Element = typename Field::Element;
+
+    explicit OnlineFieldLagrangeInterpolator(const Field& field) : field_(field) {}
+
+    void add(const Element& x, const Element& y) {
+        for (const Element& other : xs_) {
+            if (field_.equal(other, x)) {
+                throw std::invalid_argument("x-coordinates collide modulo " + field_.modulus().toString());
+            }
+        }
+        Element denominator = field_.one();
+        for (std::size_t i = 0; i < xs_.size(); ++i) {
+            Element difference = field_.sub(x, xs_[i]);
+            denominators_[i] = field_.mul(denominators_[i], difference);
+            denominator = field_.mul(denominator, field_.neg(difference));
+        }
+        xs_.push_back(x);
+        ys_.push_back(y);
+        denominators_.push_back(denominator);
+    }
+
+    std::size_t size() const { return xs_.size(); }
+
+    Element secret() const {
+        const std::size_t k = xs_.size();
+        if (k == 0) {
+            throw std::invalid_argument("Cannot interpolate without points");
+        }
+        std::vector<Element> inverses(denominators_);
+        FieldLagrangeInterpolator<Field>::batchInvert(field_, inverses);
+
+        // Π_{j≠i} x_j = prefix(i) · suffix(i)
+        std::vector<Element> suffix(k + 1);
+        suffix[k] = field_.one();
+        for (std::size_t i = k; i-- > 0;) {
+            suffix[i] = field_.mul(suffix[i + 1], xs_[i]);
+        }
+        Element prefix = field_.one();
+        for (std::size_t i = 0; i < k; ++i) {
+            inverses[i] = field_.mul(field_.mul(prefix, suffix[i + 1]), inverses[i]);
+            prefix = field_.mul(prefix, xs_[i]);
+        }
+        return field_.dot(inverses.data(), ys_.data(), k);
+    }
+
+private:
+    const Field& field_;
+    std::vector<Element> xs_;
+    std::vector<Element> ys_;
+    std::vector<Element> denominators_;
+};
+
+/**
+ * Reed–Solomon decoding of shares by Berlekamp–Welch over GF(p)
+ *
+ * n shares lie on a polynomial P of degree < k except for at most
+ * e = ⌊(n-k)/2⌋ corrupted ones. With the error locator E (monic, degree e,
+ * zero at every bad x) and Q = P·E, every share satisfies
+ *
+ *   Q(x_i) = y_i · E(x_i)
+ *
+ * n linear equations in the e + k coefficients of Q and the e low
+ * coefficients of E. Gauss-Jordan elimination solves them in O(n³) field
+ * operations; P = Q / E, and the corrupted shares are exactly those with
+ * P(x_i) ≠ y_i. With fewer than e errors the system has free variables,
+ * but every solution gives the same P, so they are simply set to zero.
+ */
+template <typename Field>
+class BerlekampWelchDecoder {
+public:
+    using Element = typename Field::Element;
+
+    struct Result {
+        std::vector<Element> coefficients;  // P, constant term first
+        std::vector<std::size_t> corrupted; // positions of the shares off P, ascending
+    };
+
+    /**
+     * Throws std::runtime_error when the shares are not within e errors of
+     * any polynomial of degree < k
+     */
+    static Result decode(const Field& field, const std::vector<Element>& xs,
+                         const std::vector<Element>& ys, std::size_t k) {
+        const std::size_t n = xs.size();
+        if (k == 0 || n < k || ys.size() != n) {
+            throw std::invalid_argument("Berlekamp-Welch needs n >= k >= 1 shares, got n = " +
+                                        std::to_string(n) + ", k = " + std::to_string(k));
+        }
+        const std::size_t e = (n - k) / 2;
+        const std::size_t qTerms = e + k;
+        const std::size_t unknowns = qTerms + e;
+
+        // Row i: [x^0 .. x^(e+k-1) | -y·x^0 .. -y·x^(e-1) | y·x^e]
+        std::vector<std::vector<Element>> rows(n, std::vector<Element>(unknowns + 1));
+        for (std::size_t i = 0; i < n; ++i) {
+            Element power = field.one();
+            for (std::size_t j = 0; j < qTerms; ++j) {
+                rows[i][j] = power;
+                if (j < e) {
+                    rows[i][qTerms + j] = field.neg(field.mul(ys[i], power));
+                } else if (j == e) {
+                    rows[i][unknowns] = field.mul(ys[i], power);
+                }
+                power = field.mul(power, xs[i]);
+            }
+        }
+        std::vector<Element> solution = solve(field, rows, unknowns);
+
+        // P = Q / E by long division; E is monic, so no inversions
+        std::vector<Element> remainder(solution.begin(), solution.begin() + static_cast<long>(qTerms));
+        std::vector<Element> locator(solution.begin() + static_cast<long>(qTerms), solution.end());
+        locator.push_back(field.one());
+        Result result;
+        result.coefficients.assign(k, field.zero());
+        for (std::size_t degree = qTerms; degree-- > e;) {
+            const Element lead = remainder[degree];
+            result.coefficients[degree - e] = lead;
+            for (std::size_t j = 0; j <= e; ++j) {
+                remainder[degree - e + j] = field.sub(remainder[degree - e + j], field.mul(lead, locator[j]));
+            }
+        }
+        for (std::size_t j = 0; j < e; ++j) {
+            if (!field.isZero(remainder[j])) {
+                throw std::runtime_error("Too many corrupted shares: more than " + std::to_string(e) +
+                                         " of " + std::to_string(n) + " are off the polynomial");
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!field.equal(evaluate(field, result.coefficients, xs[i]), ys[i])) {
+                result.corrupted.push_back(i);
+            }
+        }
+        if (result.corrupted.size() > e) {
+            throw std::runtime_error("Too many corrupted shares: " + std::to_string(result.corrupted.size()) +
+                                     " of " + std::to_string(n) + " are off the polynomial, at most " +
+                                     std::to_string(e) + " can be corrected");
+        }
+        return result;
+    }
+
+    // Horner evaluation of a coefficient vector (constant term first)
+    static Element evaluate(const Field& field, const std::vector<Element>& coefficients, const Element& x) {
+        Element value = field.zero();
+        for (std::size_t j = coefficients.size(); j-- > 0;) {
+            value = field.add(field.mul(value, x), coefficients[j]);
+        }
+        return value;
+    }
+
+private:
+    /**
+     * Gauss-Jordan elimination on an augmented system; free variables are 0
+     * Throws std::runtime_error when the system is inconsistent.
+     */
+    static std::vector<Element> solve(const Field& field, std::vector<std::vector<Element>>& rows,
+                                      std::size_t unknowns) {
+        std::vector<std::size_t> pivotColumns;
+        std::size_t rank = 0;
+        for (std::size_t column = 0; column < unknowns && rank < rows.size(); ++column) {
+            std::size_t pivot = rank;
+            while (pivot < rows.size() && field.isZero(rows[pivot][column])) {
+                ++pivot;
+            }
+            if (pivot == rows.size()) {
+                continue;
+            }
+            std::swap(rows[rank], rows[pivot]);
+            const Element scale = field.inverse(rows[rank][column]);
+            for (std::size_t j = column; j <= unknowns; ++j) {
+                rows[rank][j] = field.mul(rows[rank][j], scale);
+            }
+            for (std::size_t i = 0; i < rows.size(); ++i) {
+                if (i == rank || field.isZero(rows[i][column])) {
+                    continue;
+                }
+                const Element factor = rows[i][column];
+                for (std::size_t j = column; j <= unknowns; ++j) {
+                    rows[i][j] = field.sub(rows[i][j], field.mul(factor, rows[rank][j]));
+                }
+            }
+            pivotColumns.push_back(column);
+            ++rank;
+        }
+        for (std::size_t i = rank; i < rows.size(); ++i) {
+            if (!field.isZero(rows[i][unknowns])) {
+                throw std::runtime_error("Too many corrupted shares: no polynomial of the expected "
+                                         "degree fits enough of them");
+            }
+        }
+        std::vector<Element> solution(unknowns, field.zero());
+        for (std::size_t r = 0; r < rank; ++r) {
+            solution[pivotColumns[r]] = rows[r][unknowns];
+        }
+        return solution;
+    }
+};
+
+/**
+ * Number-theoretic transform over GF(p): an FFT whose roots of unity are
+ * field elements, which exist for sizes up to 2^s when p - 1 = 2^s · odd
+ *
+ * forward() runs decimation in frequency from natural to bit-reversed
+ * order and inverse() decimation in time back, so a convolution needs no
+ * bit-reversal pass. Levels are fused in pairs into radix-4 passes (one
+ * trip through memory per two levels) with a radix-2 pass when the level
+ * count is odd. Butterflies multiply in Montgomery form through the field;
+ * over MontgomeryField32 they run eight lanes wide on AVX2 when the CPU
+ * has it. Twiddles are precomputed once per size and kept, so an instance
+ * must not be shared between threads.
+ */
+template <typename Field>
+class NumberTheoreticTransform {
+public:
+    using Element = typename Field::Element;
+
+    explicit NumberTheoreticTransform(const Field& field) : field_(field) {
+        const BigInt order = field.modulus() - BigInt(1);
+        while (!order.testBit(twoAdicity_)) {
+            ++twoAdicity_;
+        }
+        // For a quadratic non-residue g, g^((p-1)/2^s) has order exactly 2^s
+        std::uint64_t generator = 2;
+        while (field.equal(field.pow(field.fromUint64(generator), order >> 1), field.one())) {
+            ++generator;
+        }
+        levelRoots_.resize(twoAdicity_ + 1);
+        inverseLevelRoots_.resize(twoAdicity_ + 1);
+        levelRoots_[twoAdicity_] = field.pow(field.fromUint64(generator), order >> twoAdicity_);
+        inverseLevelRoots_[twoAdicity_] = field.inverse(levelRoots_[twoAdicity_]);
+        for (std::size_t level = twoAdicity_; level > 0; --level) {
+            levelRoots_[level - 1] = field.mul(levelRoots_[level], levelRoots_[level]);
+            inverseLevelRoots_[level - 1] = field.mul(inverseLevelRoots_[level], inverseLevelRoots_[level]);
+        }
+    }
+
+    const Field& field() const { return field_; }
+
+    // The largest transform has 2^maxLog() points
+    std::size_t maxLog() const { return twoAdicity_; }
+
+    // Natural order in, bit-reversed order out; the size is a power of two
+    void forward(std::vector<Element>& a) const {
+        const std::size_t n = a.size();
+        prepare(n);
+        std::size_t half = n / 2;
+        for (; half >= 2; half /= 4) {
+            radix4Forward(a.data(), n, half);
+        }
+        if (half == 1) {
+            radix2(a.data(), n);
+        }
+    }
+
+    // Bit-reversed order in, natural order out, including the 1/n scaling
+    void inverse(std::vector<Element>& a) const {
+        const std::size_t n = a.size();
+        prepare(n);
+        std::size_t quarter = 1;
+        if (n > 1 && (__builtin_ctzll(n) & 1) != 0) {
+            radix2(a.data(), n);
+            quarter = 2;
+        }
+        for (; 4 * quarter <= n; quarter *= 4) {
+            radix4Inverse(a.data(), n, quarter);
+        }
+        const Element scale = field_.inverse(field_.fromUint64(n));
+        for (Element& value : a) {
+            value = field_.mul(value, scale);
+        }
+    }
+
+    /**
+     * p·q as a coefficient vector of size |p| + |q| - 1
+     * Throws std::length_error when that needs more than 2^maxLog() points.
+     */
+    std::vector<Element> multiply(const std::vector<Element>& p, const std::vector<Element>& q) const {
+        if (p.empty() || q.empty()) {
+            return {};
+        }
+        const std::size_t size = p.size() + q.size() - 1;
+        std::size_t log = 0;
+        while ((std::size_t(1) << log) < size) {
+            ++log;
+        }
+        if (log > twoAdicity_) {
+            throw std::length_error("NTT of 2^" + std::to_string(log) + " points exceeds the 2^" +
+                                    std::to_string(twoAdicity_) + " roots of unity modulo " +
+                                    field_.modulus().toString());
+        }
+        std::vector<Element> fp(p), fq(q);
+        fp.resize(std::size_t(1) << log, field_.zero());
+        fq.resize(fp.size(), field_.zero());
+        forward(fp);
+        forward(fq);
+        for (std::size_t i = 0; i < fp.size(); ++i) {
+            fp[i] = field_.mul(fp[i], fq[i]);
+        }
+        inverse(fp);
+        fp.resize(size);
+        return fp;
+    }
+
+private:
+    Field field_;
+    std::size_t twoAdicity_ = 0;
+    std::vector<Element> levelRoots_;         // levelRoots_[j] has order 2^j
+    std::vector<Element> inverseLevelRoots_;
+    // ω_{2h}^i and ω_{2h}^-i at h + i, for every level h = 1, 2, 4, ...
+    mutable std::vector<Element> twiddles_;
+    mutable std::vector<Element> inverseTwiddles_;
+
+    void prepare(std::size_t n) const {
+        if (n > (std::size_t(1) << twoAdicity_)) {
+            throw std::length_error("NTT size " + std::to_string(n) + " exceeds 2^" + std::to_string(twoAdicity_));
+        }
+        if (twiddles_.size() >= n) {
+            return;
+        }
+        twiddles_.assign(n, field_.one());
+        inverseTwiddles_.assign(n, field_.one());
+        for (std::size_t half = 1, level = 1; half < n; half <<= 1, ++level) {
+            for (std::size_t i = 1; i < half; ++i) {
+                twiddles_[half + i] = field_.mul(twiddles_[half + i - 1], levelRoots_[level]);
+                inverseTwiddles_[half + i] = field_.mul(inverseTwiddles_[half + i - 1], inverseLevelRoots_[level]);
+            }
+        }
+    }
+
+    // The level with half = 1, where every twiddle is 1
+    void radix2(Element* a, std::size_t n) const {
+        for (std::size_t s = 0; s < n; s += 2) {
+            const Element u = a[s], v = a[s + 1];
+            a[s] = field_.add(u, v);
+            a[s + 1] = field_.sub(u, v);
+        }
+    }
+
+    // Levels half and half/2 of the forward transform
+    void radix4Forward(Element* a, std::size_t n, std::size_t half) const {
+        const std::size_t quarter = half / 2;
+        const Element* w = twiddles_.data();
+#if defined(__x86_64__) && defined(__GNUC__)
+        if constexpr (std::is_same_v<Field, MontgomeryField32>) {
+            if (quarter >= 8 && hasAvx2()) {
+                radix4ForwardAvx2(a, n, half, w, field_.prime(), field_.negInverse());
+                return;
+            }
+        }
+#endif
+        for (std::size_t s = 0; s < n; s += 2 * half) {
+            for (std::size_t i = 0; i < quarter; ++i) {
+                Element* x = a + s + i;
+                const Element y0 = field_.add(x[0], x[half]);
+                const Element y2 = field_.mul(field_.sub(x[0], x[half]), w[half + i]);
+                const Element y1 = field_.add(x[quarter], x[half + quarter]);
+                const Element y3 = field_.mul(field_.sub(x[quarter], x[half + quarter]), w[half + quarter + i]);
+                x[0] = field_.add(y0, y1);
+                x[quarter] = field_.mul(field_.sub(y0, y1), w[quarter + i]);
+                x[half] = field_.add(y2, y3);
+                x[half + quarter] = field_.mul(field_.sub(y2, y3), w[quarter + i]);
+            }
+        }
+    }
+
+    // Levels quarter and 2·quarter of the inverse transform
+    void radix4Inverse(Element* a, std::size_t n, std::size_t quarter) const {
+        const Element* w = inverseTwiddles_.data();
+#if defined(__x86_64__) && defined(__GNUC__)
+        if constexpr (std::is_same_v<Field, MontgomeryField32>) {
+            if (quarter >= 8 && hasAvx2()) {
+                radix4InverseAvx2(a, n, quarter, w, field_.prime(), field_.negInverse());
+                return;
+            }
+        }
+#endif
+        for (std::size_t s = 0; s < n; s += 4 * quarter) {
+            for (std::size_t i = 0; i < quarter; ++i) {
+                Element* x = a + s + i;
+                const Element x1 = field_.mul(x[quarter], w[quarter + i]);
+                const Element x3 = field_.mul(x[3 * quarter], w[quarter + i]);
+                const Element y0 = field_.add(x[0], x1), y1 = field_.sub(x[0], x1);
+                const Element y2 = field_.add(x[2 * quarter], x3), y3 = field_.sub(x[2 * quarter], x3);
+                const Element t2 = field_.mul(y2, w[2 * quarter + i]);
+                const Element t3 = field_.mul(y3, w[3 * quarter + i]);
+                x[0] = field_.add(y0, t2);
+                x[2 * quarter] = field_.sub(y0, t2);
+                x[quarter] = field_.add(y1, t3);
+                x[3 * quarter] = field_.sub(y1, t3);
+            }
+        }
+    }
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    static bool hasAvx2() {
+        static const bool available = __builtin_cpu_supports("avx2");
+        return available;
+    }
+
+    // Eight-lane Montgomery arithmetic, kept with the field
+    using Lanes = MontgomeryField32;
+
+    __attribute__((target("avx2"))) static __m256i load(const std::uint32_t* from) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from));
+    }
+
+    __attribute__((target("avx2"))) static void store(std::uint32_t* to, __m256i value) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(to), value);
+    }
+
+    __attribute__((target("avx2")))
+    static void radix4ForwardAvx2(std::uint32_t* a, std::size_t n, std::size_t half, const std::uint32_t* w,
+                                  std::uint32_t prime, std::uint32_t negInverse) {
+        const std::size_t quarter = half / 2;
+        const __m256i p = _mm256_set1_epi32(static_cast<int>(prime));
+        const __m256i pNegInv = _mm256_set1_epi32(static_cast<int>(negInverse));
+        for (std::size_t s = 0; s < n; s += 2 * half) {
+            for (std::size_t i = 0; i < quarter; i += 8) {
+                std::uint32_t* x = a + s + i;
+                const __m256i x0 = load(x), x1 = load(x + quarter), x2 = load(x + half), x3 = load(x + half + quarter);
+                const __m256i w1 = load(w + quarter + i);
+                const __m256i y0 = Lanes::addAvx2(x0, x2, p);
+                const __m256i y2 = Lanes::mulAvx2(Lanes::subAvx2(x0, x2, p), load(w + half + i), p, pNegInv);
+                const __m256i y1 = Lanes::addAvx2(x1, x3, p);
+                const __m256i y3 = Lanes::mulAvx2(Lanes::subAvx2(x1, x3, p), load(w + half + quarter + i), p, pNegInv);
+                store(x, Lanes::addAvx2(y0, y1, p));
+                store(x + quarter, Lanes::mulAvx2(Lanes::subAvx2(y0, y1, p), w1, p, pNegInv));
+                store(x + half, Lanes::addAvx2(y2, y3, p));
+                store(x + half + quarter, Lanes::mulAvx2(Lanes::subAvx2(y2, y3, p), w1, p, pNegInv));
+            }
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void radix4InverseAvx2(std::uint32_t* a, std::size_t n, std::size_t quarter, const std::uint32_t* w,
+                                  std::uint32_t prime, std::uint32_t negInverse) {
+        const __m256i p = _mm256_set1_epi32(static_cast<int>(prime));
+        const __m256i pNegInv = _mm256_set1_epi32(static_cast<int>(negInverse));
+        for (std::size_t s = 0; s < n; s += 4 * quarter) {
+            for (std::size_t i = 0; i < quarter; i += 8) {
+                std::uint32_t* x = a + s + i;
+                const __m256i w1 = load(w + quarter + i);
+                const __m256i x0 = load(x), x2 = load(x + 2 * quarter);
+                const __m256i x1 = Lanes::mulAvx2(load(x + quarter), w1, p, pNegInv);
+                const __m256i x3 = Lanes::mulAvx2(load(x + 3 * quarter), w1, p, pNegInv);
+                const __m256i y0 = Lanes::addAvx2(x0, x1, p), y1 = Lanes::subAvx2(x0, x1, p);
+                const __m256i t2 = Lanes::mulAvx2(Lanes::addAvx2(x2, x3, p), load(w + 2 * quarter + i), p, pNegInv);
+                const __m256i t3 = Lanes::mulAvx2(Lanes::subAvx2(x2, x3, p), load(w + 3 * quarter + i), p, pNegInv);
+                store(x, Lanes::addAvx2(y0, t2, p));
+                store(x + 2 * quarter, Lanes::subAvx2(y0, t2, p));
+                store(x + quarter, Lanes::addAvx2(y1, t3, p));
+                store(x + 3 * quarter, Lanes::subAvx2(y1, t3, p));
+            }
+        }
+    }
+#endif
+};
+
+/**
+ * The integers in the shape of a Field, so PolynomialArithmetic works over Z
+ *
+ * Only ±1 are invertible, so polynomial division is limited to monic (or
+ * -monic) divisors, which is all a subproduct tree divides by. Quotients by
+ * them stay integral, which makes multipoint evaluation exact.
+ */
+class IntegerRing {
+public:
+    using Element = BigInt;
+
+    Element zero() const { return BigInt(); }
+    Element one() const { return BigInt(1); }
+    Element fromUint64(std::uint64_t value) const { return BigInt(value); }
+    bool isZero(const Element& a) const { return a.isZero(); }
+    bool equal(const Element& a, const Element& b) const { return a == b; }
+    Element add(const Element& a, const Element& b) const { return a + b; }
+    Element sub(const Element& a, const Element& b) const { return a - b; }
+    Element mul(const Element& a, const Element& b) const { return a * b; }
+    Element neg(const Element& a) const { return -a; }
+
+    // Throws std::domain_error unless a is ±1
+    Element inverse(const Element& a) const {
+        if (a != BigInt(1) && a != BigInt(-1)) {
+            throw std::domain_error("Only ±1 are invertible over the integers, not " + a.toString());
+        }
+        return a;
+    }
+};
+
+/**
+ * Exact products of integer polynomials by NTTs modulo several 30-bit
+ * primes, recombined with the Chinese remainder theorem
+ *
+ * A coefficient of p·q is at most min(|p|, |q|) · max|p_i| · max|q_j| in
+ * absolute value, so just enough primes are used for their product to
+ * exceed twice that. Garner's mixed-radix form rebuilds each signed
+ * coefficient with one BigInt multiply-add per prime. The primes are
+ * c·2^16 + 1 < 2^30, largest first, restricted to those with enough roots
+ * of unity for the product size. Holds one transform (and its twiddles)
+ * per prime; not thread-safe.
+ */
+class CrtPolynomialMultiplier {
+public:
+    CrtPolynomialMultiplier() = default;
+    // Lets PolynomialArithmetic<IntegerRing> build one like a field's transform
+    explicit CrtPolynomialMultiplier(const IntegerRing&) {}
+
+    // Every prime has roots of unity of order 2^16
+    std::size_t maxLog() const { return kPrimeShift; }
+
+    /**
+     * Throws std::length_error when the product is too long or its
+     * coefficients too large for the available primes
+     */
+    std::vector<BigInt> multiply(const std::vector<BigInt>& p, const std::vector<BigInt>& q) const {
+        if (p.empty() || q.empty()) {
+            return {};
+        }
+        const std::size_t size = p.size() + q.size() - 1;
+        std::size_t log = 0;
+        while ((std::size_t(1) << log) < size) {
+            ++log;
+        }
+        auto maxBits = [](const std::vector<BigInt>& coefficients) {
+            std::size_t bits = 0;
+            for (const BigInt& c : coefficients) {
+                bits = std::max(bits, c.bitLength());
+            }
+            return bits;
+        };
+        std::size_t terms = 0;
+        while ((std::size_t(1) << terms) < std::min(p.size(), q.size())) {
+            ++terms;
+        }
+        const std::size_t bound = maxBits(p) + maxBits(q) + terms + 1;  // bits of 2·max|coefficient|
+
+        // Every prime is above 2^29, so each contributes more than 29 bits
+        std::vector<const Channel*> used;
+        for (std::size_t index = 0; used.size() * 29 <= bound; ++index) {
+            const Channel* channel = channelAt(index);
+            if (channel == nullptr) {
+                throw std::length_error("Polynomial product needs more than " + std::to_string(used.size()) +
+                                        " NTT primes");
+            }
+            if (channel->transform.maxLog() >= log) {
+                used.push_back(channel);
+            }
+        }
+
+        std::vector<std::vector<std::uint32_t>> residues;
+        for (const Channel* channel : used) {
+            const MontgomeryField32& field = channel->transform.field();
+            std::vector<std::uint32_t> fp, fq;
+            for (const BigInt& c : p) {
+                fp.push_back(field.fromBigInt(c));
+            }
+            for (const BigInt& c : q) {
+                fq.push_back(field.fromBigInt(c));
+            }
+            std::vector<std::uint32_t> product = channel->transform.multiply(fp, fq);
+            for (std::uint32_t& value : product) {
+                value = field.toUint32(value);
+            }
+            residues.push_back(std::move(product));
+        }
+        return combine(used, residues, size);
+    }
+
+private:
+    static constexpr std::size_t kPrimeShift = 16;
+
+    struct Channel {
+        NumberTheoreticTransform<MontgomeryField32> transform;
+        explicit Channel(std::uint32_t prime) : transform(MontgomeryField32(prime)) {}
+    };
+
+    mutable std::vector<std::unique_ptr<Channel>> channels_;
+    mutable std::uint32_t nextMultiplier_ = (1u << (30 - kPrimeShift)) - 1;
+
+    // The index-th prime, found on first use; null when they run out
+    const Channel* channelAt(std::size_t index) const {
+        while (channels_.size() <= index && nextMultiplier_ >= (1u << (29 - kPrimeShift))) {
+            const std::uint32_t candidate = (nextMultiplier_-- << kPrimeShift) + 1;
+            if (MontgomeryField<1>(BigInt(candidate)).isProbablePrime()) {
+                channels_.push_back(std::make_unique<Channel>(candidate));
+            }
+        }
+        return index < channels_.size() ? channels_[index].get() : nullptr;
+    }
+
+    /**
+     * Garner: x = v_0 + v_1·m_0 + v_2·m_0·m_1 + ..., each digit v_i found
+     * modulo m_i from the ones before it; x above M/2 stands for x - M
+     */
+    static std::vector<BigInt> combine(const std::vector<const Channel*>& used,
+                                       const std::vector<std::vector<std::uint32_t>>& residues, std::size_t size) {
+        const std::size_t count = used.size();
+        std::vector<std::uint64_t> moduli(count), prefixInverses(count);
+        BigInt modulusProduct(1);
+        for (std::size_t i = 0; i < count; ++i) {
+            moduli[i] = used[i]->transform.field().prime();
+            std::uint64_t prefix = 1;
+            for (std::size_t j = 0; j < i; ++j) {
+                prefix = prefix * moduli[j] % moduli[i];
+            }
+            prefixInverses[i] = powMod(prefix, moduli[i] - 2, moduli[i]);
+            modulusProduct.mulAddSmall(moduli[i], 0);
+        }
+        const BigInt halfProduct = modulusProduct >> 1;
+
+        std::vector<BigInt> result(size);
+        std::vector<std::uint64_t> digits(count);
+        for (std::size_t c = 0; c < size; ++c) {
+            for (std::size_t i = 0; i < count; ++i) {
+                // Value of the digits so far modulo m_i, by Horner from the top
+                std::uint64_t partial = 0;
+                for (std::size_t j = i; j-- > 0;) {
+                    partial = (partial * moduli[j] + digits[j]) % moduli[i];
+                }
+                digits[i] = (residues[i][c] + moduli[i] - partial) % moduli[i] * prefixInverses[i] % moduli[i];
+            }
+            BigInt value;
+            for (std::size_t i = count; i-- > 0;) {
+                value.mulAddSmall(i + 1 < count ? moduli[i] : 0, digits[i]);
+            }
+            if (value > halfProduct) {
+                value -= modulusProduct;
+            }
+            result[c] = std::move(value);
+        }
+        return result;
+    }
+
+    static std::uint64_t powMod(std::uint64_t base, std::uint64_t exponent, std::uint64_t modulus) {
+        std::uint64_t result = 1;
+        for (base %= modulus; exponent != 0; exponent >>= 1) {
+            if (exponent & 1) {
+                result = result * base % modulus;
+            }
+            base = base * base % modulus;
+        }
+        return result;
+    }
+};
+
+/**
+ * Dense polynomial arithmetic over GF(p), fast when p - 1 = 2^s · odd has a
+ * large s (an NTT prime such as 2^64 - 2^32 + 1), or over IntegerRing
+ *
+ * Polynomials are coefficient vectors, constant term first, without
+ * trailing zeros, so the zero polynomial is empty. Products go through a
+ * NumberTheoreticTransform (which needs a root of unity of order
+ * 2^⌈log₂ size⌉) above a schoolbook cutoff, quotients through a
+ * Newton inverse of the reversed divisor, and products of many linear
+ * factors through a subproduct tree. Multipoint evaluation, interpolation
+ * and the half-GCD thus all cost O(M(n) log n) = O(n log² n); with too few
+ * roots of unity products fall back to schoolbook and stay correct. Over
+ * the integers a CrtPolynomialMultiplier takes the transform's place, and
+ * products with coefficients beyond its primes go schoolbook as well.
+ */
+template <typename Field>
+class PolynomialArithmetic {
+public:
+    using Element = typename Field::Element;
+    using Polynomial = std::vector<Element>;
+
+    // [[a, b], [c, d]] acting on a column of two polynomials
+    struct Matrix {
+        Polynomial a, b, c, d;
+    };
+
+    /**
+     * Products of (x - x_i) over ranges of the points: node 0 covers [0, n),
+     * node i splits into 2i+1 (first half) and 2i+2 (second half)
+     */
+    struct SubproductTree {
+        std::vector<Polynomial> nodes;
+        std::size_t points = 0;
+
+        const Polynomial& root() const { return nodes[0]; }
+    };
+
+    explicit PolynomialArithmetic(const Field& field) : field_(field), multiplier_(field) {}
+
+    static long degree(const Polynomial& p) { return static_cast<long>(p.size()) - 1; }
+
+    Polynomial add(const Polynomial& p, const Polynomial& q) const {
+        Polynomial sum(std::max(p.size(), q.size()), field_.zero());
+        for (std::size_t i = 0; i < sum.size(); ++i) {
+            sum[i] = i >= p.size() ? q[i] : i >= q.size() ? p[i] : field_.add(p[i], q[i]);
+        }
+        return trimmed(std::move(sum));
+    }
+
+    Polynomial sub(const Polynomial& p, const Polynomial& q) const {
+        Polynomial difference(std::max(p.size(), q.size()), field_.zero());
+        for (std::size_t i = 0; i < difference.size(); ++i) {
+            difference[i] = field_.sub(i < p.size() ? p[i] : field_.zero(), i < q.size() ? q[i] : field_.zero());
+        }
+        return trimmed(std::move(difference));
+    }
+
+    Polynomial multiply(const Polynomial& p, const Polynomial& q) const {
+        if (p.empty() || q.empty()) {
+            return {};
+        }
+        const std::size_t size = p.size() + q.size() - 1;
+        std::size_t log = 0;
+        while ((std::size_t(1) << log) < size) {
+            ++log;
+        }
+        if (std::min(p.size(), q.size()) <= kSchoolbookCutoff || log > multiplier_.maxLog()) {
+            return schoolbook(p, q);
+        }
+        try {
+            return multiplier_.multiply(p, q);
+        } catch (const std::length_error&) {
+            // Integer coefficients too wide for the CRT primes
+            return schoolbook(p, q);
+        }
+    }
+
+    Polynomial derivative(const Polynomial& p) const {
+        Polynomial result(p.empty() ? 0 : p.size() - 1);
+        for (std::size_t i = 1; i < p.size(); ++i) {
+            result[i - 1] = field_.mul(p[i], field_.fromUint64(i));
+        }
+        return trimmed(std::move(result));
+    }
+
+    /**
+     * Quotient and remainder of p / q
+     * Throws std::domain_error when q is zero.
+     */
+    std::pair<Polynomial, Polynomial> divmod(const Polynomial& p, const Polynomial& q) const {
+        if (q.empty()) {
+            throw std::domain_error("Polynomial division by zero");
+        }
+        if (p.size() < q.size()) {
+            return {{}, p};
+        }
+        const std::size_t quotientSize = p.size() - q.size() + 1;
+        Polynomial quotient;
+        if (std::min(quotientSize, q.size()) <= kSchoolbookCutoff) {
+            Polynomial remainder(p);
+            quotient.assign(quotientSize, field_.zero());
+            const Element leadInverse = field_.inverse(q.back());
+            for (std::size_t i = quotientSize; i-- > 0;) {
+                const Element factor = field_.mul(remainder[i + q.size() - 1], leadInverse);
+                quotient[i] = factor;
+                for (std::size_t j = 0; j < q.size(); ++j) {
+                    remainder[i + j] = field_.sub(remainder[i + j], field_.mul(factor, q[j]));
+                }
+            }
+            remainder.resize(q.size() - 1);
+            return {std::move(quotient), trimmed(std::move(remainder))};
+        }
+
+        // rev(quotient) = rev(p) / rev(q) mod x^quotientSize
+        Polynomial reversedP(p.rbegin(), p.rbegin() + static_cast<long>(quotientSize));
+        Polynomial reversedQ(q.rbegin(), q.rend());
+        quotient = truncated(multiply(reversedP, inverseSeries(reversedQ, quotientSize)), quotientSize);
+        quotient.resize(quotientSize, field_.zero());
+        std::reverse(quotient.begin(), quotient.end());
+        Polynomial remainder = sub(p, multiply(quotient, q));
+        return {std::move(quotient), std::move(remainder)};
+    }
+
+    SubproductTree subproductTree(const std::vector<Element>& xs) const {
+        if (xs.empty()) {
+            throw std::invalid_argument("Subproduct tree needs at least one point");
+        }
+        SubproductTree tree;
+        tree.points = xs.size();
+        tree.nodes.resize(4 * xs.size());
+        build(tree, 0, 0, xs.size(), xs);
+        return tree;
+    }
+
+    // p(x_i) for every point of the tree
+    std::vector<Element> evaluate(const Polynomial& p, const SubproductTree& tree,
+                                  const std::vector<Element>& xs) const {
+        std::vector<Element> values(tree.points);
+        evaluateNode(divmod(p, tree.root()).second, tree, 0, 0, tree.points, xs, values);
+        return values;
+    }
+
+    /**
+     * The polynomial of degree < n through (x_i, y_i)
+     *   f = Σ y_i / g'(x_i) · g / (x - x_i),  g = Π (x - x_j)
+     * Throws std::invalid_argument when two x collide mod p.
+     */
+    Polynomial interpolate(const SubproductTree& tree, const std::vector<Element>& xs,
+                           const std::vector<Element>& ys) const {
+        std::vector<Element> weights = evaluate(derivative(tree.root()), tree, xs);
+        for (const Element& weight : weights) {
+            if (field_.isZero(weight)) {
+                throw std::invalid_argument("Interpolation points collide modulo p");
+            }
+        }
+        FieldLagrangeInterpolator<Field>::batchInvert(field_, weights);
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            weights[i] = field_.mul(weights[i], ys[i]);
+        }
+        return linearCombination(tree, weights);
+    }
+
+    // Σ w_i · g / (x - x_i) with g = Π (x - x_j), combined up the tree
+    Polynomial linearCombination(const SubproductTree& tree, const std::vector<Element>& weights) const {
+        return combine(tree, 0, 0, tree.points, weights);
+    }
+
+    /**
+     * Runs the extended Euclidean algorithm on (p, q), deg p > deg q, up to
+     * the first remainder r = u·p + v·q with deg r < threshold, and returns
+     * (r, v)
+     *
+     * The quotients that bring p from degree n down to 2·threshold - n depend
+     * only on the top coefficients, so one half-GCD of p and q shifted down
+     * by 2·threshold - n does the whole job.
+     */
+    std::pair<Polynomial, Polynomial> partialGcd(const Polynomial& p, const Polynomial& q,
+                                                 std::size_t threshold) const {
+        Matrix m{{field_.one()}, {}, {}, {field_.one()}};
+        if (degree(q) >= static_cast<long>(threshold)) {
+            const long shift = std::max(0L, 2 * static_cast<long>(threshold) - degree(p));
+            m = halfGcd(shiftedDown(p, static_cast<std::size_t>(shift)), shiftedDown(q, static_cast<std::size_t>(shift)));
+        }
+        auto [r0, r1] = apply(m, p, q);
+        while (degree(r1) >= static_cast<long>(threshold)) {
+            auto [quotient, remainder] = divmod(r0, r1);
+            m = stepped(m, quotient);
+            r0 = std::move(r1);
+            r1 = std::move(remainder);
+        }
+        return {std::move(r1), std::move(m.d)};
+    }
+
+private:
+    // Smaller operands multiply and divide faster by schoolbook
+    static constexpr std::size_t kSchoolbookCutoff = 32;
+
+    using Multiplier = std::conditional_t<std::is_same<Field, IntegerRing>::value, CrtPolynomialMultiplier,
+                                          NumberTheoreticTransform<Field>>;
+
+    const Field& field_;
+    Multiplier multiplier_;
+
+    Polynomial schoolbook(const Polynomial& p, const Polynomial& q) const {
+        Polynomial product(p.size() + q.size() - 1, field_.zero());
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            for (std::size_t j = 0; j < q.size(); ++j) {
+                product[i + j] = field_.add(product[i + j], field_.mul(p[i], q[j]));
+            }
+        }
+        return product;
+    }
+
+    Polynomial trimmed(Polynomial p) const {
+        while (!p.empty() && field_.isZero(p.back())) {
+            p.pop_back();
+        }
+        return p;
+    }
+
+    Polynomial truncated(Polynomial p, std::size_t size) const {
+        if (p.size() > size) {
+            p.resize(size);
+        }
+        return trimmed(std::move(p));
+    }
+
+    static Polynomial shiftedDown(const Polynomial& p, std::size_t shift) {
+        return shift >= p.size() ? Polynomial() : Polynomial(p.begin() + static_cast<long>(shift), p.end());
+    }
+
+    // 1 / f mod x^size by Newton iteration g ← g·(2 - f·g), doubling the precision
+    Polynomial inverseSeries(const Polynomial& f, std::size_t size) const {
+        Polynomial g{field_.inverse(f[0])};
+        for (std::size_t precision = 1; precision < size; precision <<= 1) {
+            const std::size_t next = 2 * precision;
+            Polynomial head(f.begin(), f.begin() + static_cast<long>(std::min(f.size(), next)));
+            Polynomial error = truncated(multiply(head, g), next);
+            error = sub(error, {field_.one()});
+            g = truncated(sub(g, truncated(multiply(g, error), next)), next);
+        }
+        return truncated(std::move(g), size);
+    }
+
+    void build(SubproductTree& tree, std::size_t node, std::size_t lo, std::size_t hi,
+               const std::vector<Element>& xs) const {
+        if (hi - lo == 1) {
+            tree.nodes[node] = {field_.neg(xs[lo]), field_.one()};
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        build(tree, 2 * node + 1, lo, mid, xs);
+        build(tree, 2 * node + 2, mid, hi, xs);
+        tree.nodes[node] = multiply(tree.nodes[2 * node + 1], tree.nodes[2 * node + 2]);
+    }
+
+    // p is already reduced modulo the node's product
+    void evaluateNode(const Polynomial& p, const SubproductTree& tree, std::size_t node, std::size_t lo,
+                      std::size_t hi, const std::vector<Element>& xs, std::vector<Element>& values) const {
+        if (hi - lo <= kSchoolbookCutoff) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                Element value = field_.zero();
+                for (std::size_t j = p.size(); j-- > 0;) {
+                    value = field_.add(field_.mul(value, xs[i]), p[j]);
+                }
+                values[i] = value;
+            }
+            return;
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        evaluateNode(divmod(p, tree.nodes[2 * node + 1]).second, tree, 2 * node + 1, lo, mid, xs, values);
+        evaluateNode(divmod(p, tree.nodes[2 * node + 2]).second, tree, 2 * node + 2, mid, hi, xs, values);
+    }
+
+    Polynomial combine(const SubproductTree& tree, std::size_t node, std::size_t lo, std::size_t hi,
+                       const std::vector<Element>& weights) const {
+        if (hi - lo == 1) {
+            return trimmed({weights[lo]});
+        }
+        const std::size_t mid = lo + (hi - lo) / 2;
+        return add(multiply(combine(tree, 2 * node + 1, lo, mid, weights), tree.nodes[2 * node + 2]),
+                   multiply(combine(tree, 2 * node + 2, mid, hi, weights), tree.nodes[2 * node + 1]));
+    }
+
+    std::pair<Polynomial, Polynomial> apply(const Matrix& m, const Polynomial& p, const Polynomial& q) const {
+        return {add(multiply(m.a, p), multiply(m.b, q)), add(multiply(m.c, p), multiply(m.d, q))};
+    }
+
+    // S · R
+    Matrix compose(const Matrix& s, const Matrix& r) const {
+        return {add(multiply(s.a, r.a), multiply(s.b, r.c)), add(multiply(s.a, r.b), multiply(s.b, r.d)),
+                add(multiply(s.c, r.a), multiply(s.d, r.c)), add(multiply(s.c, r.b), multiply(s.d, r.d))};
+    }
+
+    // [[0, 1], [1, -quotient]] · R, one Euclidean step
+    Matrix stepped(const Matrix& r, const Polynomial& quotient) const {
+        return {r.c, r.d, sub(r.a, multiply(quotient, r.c)), sub(r.b, multiply(quotient, r.d))};
+    }
+
+    /**
+     * Half-GCD (Thull–Yap): for deg p > deg q, the product M of the
+     * Euclidean steps that take (p, q) to the consecutive remainders (r0, r1)
+     * with deg r0 ≥ ⌈deg p / 2⌉ > deg r1
+     */
+    Matrix halfGcd(const Polynomial& p, const Polynomial& q) const {
+        const long m = (degree(p) + 1) / 2;
+        Matrix identity{{field_.one()}, {}, {}, {field_.one()}};
+        if (degree(q) < m) {
+            return identity;
+        }
+        Matrix r = halfGcd(shiftedDown(p, static_cast<std::size_t>(m)), shiftedDown(q, static_cast<std::size_t>(m)));
+        auto [r0, r1] = apply(r, p, q);
+        if (degree(r1) < m) {
+            return r;
+        }
+        auto [quotient, remainder] = divmod(r0, r1);
+        r = stepped(r, quotient);
+        if (degree(remainder) < m) {
+            return r;
+        }
+        const std::size_t shift = static_cast<std::size_t>(2 * m - degree(r1));
+        return compose(halfGcd(shiftedDown(r1, shift), shiftedDown(remainder, shift)), r);
+    }
+};
+
+/**
+ * Reed–Solomon decoding of shares by Gao's algorithm over GF(p)
+ *
+ * With g0 = Π (x - x_i) and g1 the interpolant of all n shares, extended
+ * Euclid on (g0, g1), stopped at the first remainder g = u·g0 + v·g1 of
+ * degree < (n+k)/2, leaves v as the error locator and P = g / v, provided
+ * at most e = ⌊(n-k)/2⌋ shares are corrupted. On the subproduct tree and the
+ * half-GCD a decode costs O(n log² n) field operations where
+ * Berlekamp–Welch needs O(n³), as long as p is an NTT prime.
+ */
+template <typename Field>
+class GaoDecoder {
+public:
+    using Element = typename Field::Element;
+    using Result = typename BerlekampWelchDecoder<Field>::Result;
+
+    /**
+     * Throws std::runtime_error when the shares are not within e errors of
+     * any polynomial of degree < k
+     */
+    static Result decode(const Field& field, const std::vector<Element>& xs,
+                         const std::vector<Element>& ys, std::size_t k) {
+        const std::size_t n = xs.size();
+        if (k == 0 || n < k || ys.size() != n) {
+            throw std::invalid_argument("Gao decoding needs n >= k >= 1 shares, got n = " +
+                                        std::to_string(n) + ", k = " + std::to_string(k));
+        }
+        const std::size_t e = (n - k) / 2;
+        const PolynomialArithmetic<Field> arithmetic(field);
+        const auto tree = arithmetic.subproductTree(xs);
+        const auto interpolant = arithmetic.interpolate(tree, xs, ys);
+        auto [remainder, locator] = arithmetic.partialGcd(tree.root(), interpolant, (n + k + 1) / 2);
+        auto [message, rest] = arithmetic.divmod(remainder, locator);
+        if (!rest.empty() || message.size() > k) {
+            throw std::runtime_error("Too many corrupted shares: more than " + std::to_string(e) +
+                                     " of " + std::to_string(n) + " are off the polynomial");
+        }
+
+        Result result;
+        const std::vector<Element> values = arithmetic.evaluate(message, tree, xs);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!field.equal(values[i], ys[i])) {
+                result.corrupted.push_back(i);
+            }
+        }
+        if (result.corrupted.size() > e) {
+            throw std::runtime_error("Too many corrupted shares: " + std::to_string(result.corrupted.size()) +
+                                     " of " + std::to_string(n) + " are off the polynomial, at most " +
+                                     std::to_string(e) + " can be corrected");
+        }
+        result.coefficients = std::move(message);
+        result.coefficients.resize(k, field.zero());
+        return result;
+    }
+};
+
+/**
+ * Runs body(i) for every i in [0, count) on a fixed number of threads
+ *
+ * Each worker starts with an equal slice of the index range and takes
+ * indices from the front of its own slice. A worker that runs dry steals
+ * the back half of another worker's remaining slice, so a few slow items
+ * (huge files) do not leave the other cores idle. No indices are added
+ * during a run, so a worker that finds every slice empty is done.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(std::size_t threads) : threads_(std::max<std::size_t>(threads, 1)) {}
+
+    static std::size_t hardwareThreads() {
+        unsigned threads = std::thread::hardware_concurrency();
+        return threads != 0 ? threads : 1;
+    }
+
+    template <typename Body>
+    void forEach(std::size_t count, Body body) const {
+        if (count == 0) {
+            return;
+        }
+        const std::size_t workers = std::min(threads_, count);
+        std::vector<Slice> slices(workers);
+        for (std::size_t w = 0; w < workers; ++w) {
+            slices[w].next = count * w / workers;
+            slices[w].end = count * (w + 1) / workers;
+        }
+
+        auto work = [&](std::size_t self) {
+            std::size_t index;
+            while (takeOwn(slices[self], index) || steal(slices, self, index)) {
+                body(index);
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (std::size_t w = 1; w < workers; ++w) {
+            threads.emplace_back(work, w);
+        }
+        work(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    // Remaining indices [next, end) of one worker, on its own cache line
+    struct alignas(64) Slice {
+        std::mutex lock;
+        std::size_t next = 0;
+        std::size_t end = 0;
+    };
+
+    std::size_t threads_;
+
+    static bool takeOwn(Slice& slice, std::size_t& index) {
+        std::lock_guard<std::mutex> guard(slice.lock);
+        if (slice.next == slice.end) {
+            return false;
+        }
+        index = slice.next++;
+        return true;
+    }
+
+    static bool steal(std::vector<Slice>& slices, std::size_t self, std::size_t& index) {
+        for (std::size_t offset = 1; offset < slices.size(); ++offset) {
+            Slice& victim = slices[(self + offset) % slices.size()];
+            std::size_t from, to;
+            {
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (victim.next == victim.end) {
+                    continue;
+                }
+                from = victim.next + (victim.end - victim.next) / 2;
+                to = victim.end;
+                victim.end = from;
+            }
+            std::lock_guard<std::mutex> guard(slices[self].lock);
+            index = from;
+            slices[self].next = from + 1;
+            slices[self].end = to;
+            return true;
+        }
+        return false;
+    }
+};
+
+/**
+ * f(0) for many secrets whose shares sit at one set of x-coordinates
+ *
+ * ys is column-major, secrets × k: share i of secret s is ys[i·secrets + s],
+ * so a column holds the same share of every secret. With the weights fixed
+ * the batch is one matrix-vector product, run as scaled column sums: each
+ * tile of kTile secrets keeps its accumulators in L1 while the k columns
+ * stream past it, four columns per pass. Tiles are independent and spread
+ * over threads. Over MontgomeryField32 eight secrets share one AVX2 lane
+ * group; over IntegerRing the sums are exact and the caller divides by D.
+ */
+template <typename Field>
+class BatchLagrangeKernel {
+public:
+    using Element = typename Field::Element;
+
+    // Secrets per tile: 512 accumulators stay within L1 for one-limb fields
+    static constexpr std::size_t kTile = 512;
+
+    /**
+     * out[s] = Σ_i weights[i] · ys[i·secrets + s] for every s < secrets
+     */
+    static void run(const Field& field, const std::vector<Element>& weights, const Element* ys, std::size_t secrets,
+                    Element* out, std::size_t threads = 1) {
+        const std::size_t tiles = (secrets + kTile - 1) / kTile;
+        WorkStealingPool(threads).forEach(tiles, [&](std::size_t t) {
+            const std::size_t begin = t * kTile;
+            tile(field, weights, ys, secrets, begin, std::min(begin + kTile, secrets), out);
+        });
+    }
+
+private:
+    static void tile(const Field& field, const std::vector<Element>& weights, const Element* ys, std::size_t secrets,
+                     std::size_t begin, std::size_t end, Element* out) {
+        const std::size_t k = weights.size();
+#if defined(__x86_64__) && defined(__GNUC__)
+        if constexpr (std::is_same_v<Field, MontgomeryField32>) {
+            static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+            if (hasAvx2) {
+                const std::size_t vectorEnd = begin + (end - begin) / 8 * 8;
+                tileAvx2(weights.data(), k, ys, secrets, begin, vectorEnd, out, field.prime(), field.negInverse());
+                begin = vectorEnd;
+            }
+        }
+#endif
+        for (std::size_t s = begin; s < end; ++s) {
+            out[s] = field.zero();
+        }
+        for (std::size_t i = 0; i < k; ++i) {
+            const Element& weight = weights[i];
+            const Element* column = ys + i * secrets;
+            for (std::size_t s = begin; s < end; ++s) {
+                if constexpr (std::is_same_v<Field, IntegerRing>) {
+                    out[s] += weight * column[s];
+                } else {
+                    out[s] = field.add(out[s], field.mul(weight, column[s]));
+                }
+            }
+        }
+    }
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    using Lanes = MontgomeryField32;
+
+    // [begin, end) is a whole number of 8-secret groups
+    __attribute__((target("avx2")))
+    static void tileAvx2(const std::uint32_t* weights, std::size_t k, const std::uint32_t* ys, std::size_t secrets,
+                         std::size_t begin, std::size_t end, std::uint32_t* out, std::uint32_t prime,
+                         std::uint32_t negInverse) {
+        const __m256i p = _mm256_set1_epi32(static_cast<int>(prime));
+        const __m256i pNegInv = _mm256_set1_epi32(static_cast<int>(negInverse));
+        for (std::size_t s = begin; s < end; s += 8) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + s), _mm256_setzero_si256());
+        }
+        std::size_t i = 0;
+        for (; i + 4 <= k; i += 4) {
+            const __m256i w0 = _mm256_set1_epi32(static_cast<int>(weights[i]));
+            const __m256i w1 = _mm256_set1_epi32(static_cast<int>(weights[i + 1]));
+            const __m256i w2 = _mm256_set1_epi32(static_cast<int>(weights[i + 2]));
+            const __m256i w3 = _mm256_set1_epi32(static_cast<int>(weights[i + 3]));
+            const std::uint32_t* column = ys + i * secrets;
+            for (std::size_t s = begin; s < end; s += 8) {
+                __m256i* accumulator = reinterpret_cast<__m256i*>(out + s);
+                const __m256i a = Lanes::addAvx2(Lanes::mulAvx2(w0, load(column + s), p, pNegInv),
+                                                 Lanes::mulAvx2(w1, load(column + secrets + s), p, pNegInv), p);
+                const __m256i b = Lanes::addAvx2(Lanes::mulAvx2(w2, load(column + 2 * secrets + s), p, pNegInv),
+                                                 Lanes::mulAvx2(w3, load(column + 3 * secrets + s), p, pNegInv), p);
+                _mm256_storeu_si256(accumulator,
+                                    Lanes::addAvx2(_mm256_loadu_si256(accumulator), Lanes::addAvx2(a, b, p), p));
+            }
+        }
+        for (; i < k; ++i) {
+            const __m256i w = _mm256_set1_epi32(static_cast<int>(weights[i]));
+            const std::uint32_t* column = ys + i * secrets;
+            for (std::size_t s = begin; s < end; s += 8) {
+                __m256i* accumulator = reinterpret_cast<__m256i*>(out + s);
+                _mm256_storeu_si256(accumulator, Lanes::addAvx2(_mm256_loadu_si256(accumulator),
+                                                                Lanes::mulAvx2(w, load(column + s), p, pNegInv), p));
+            }
+        }
+    }
+
+    __attribute__((target("avx2"))) static __m256i load(const std::uint32_t* from) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from));
+    }
+#endif
+};
+
+/**
+ * Majority vote on f(0) over the k-subsets of n shares
+ *
+ * Every k-subset S interpolates to a candidate constant
+ *
+ *   c_S = X_S · Σ_{i∈S} y_i · w_i,   X_S = Π_{j∈S} x_j,
+ *   w_i = 1 / (x_i · Π_{j∈S, j≠i} (x_j - x_i))
+ *
+ * Subsets are visited in revolving-door order, a Gray code in which
+ * neighbours swap one share a out for one share b, so every w_i that stays
+ * is only rescaled by (x_a - x_i) / (x_b - x_i). With all n² pairwise
+ * 1 / (x_a - x_i) inverted up front in one batch, a step costs O(k)
+ * multiplies and no inversions instead of O(k²).
+ *
+ * The rank range is cut into blocks that a WorkStealingPool spreads over
+ * the threads. The first subset of each block, and any subset whose
+ * constant has come up before, has its polynomial checked against all n
+ * shares. Two polynomials of degree < k meet in at most k-1 points, so once
+ * more than (n+k-1)/2 shares lie on one, no other can fit as many: the vote
+ * is decided and every worker stops. Otherwise the best supported
+ * polynomial wins when the enumeration is done.
+ */
+template <typename Field>
+class SubsetVote {
+    friend class SolverBenchmarks;
+
+public:
+    using Element = typename Field::Element;
+
+    struct Result {
+        Element secret{};                   // f(0) of the winning polynomial
+        std::vector<std::size_t> subset;    // k shares spanning it, ascending
+        std::vector<std::size_t> outliers;  // shares off it, ascending
+        std::uint64_t visited = 0;          // subsets interpolated
+        bool majority = false;              // decided early by a share majority
+    };
+
+    // Distinct constants remembered before the vote gives up
+    static constexpr std::size_t kMaxTracked = std::size_t(1) << 22;
+
+    /**
+     * Throws std::invalid_argument when an x is 0 or two collide mod p, and
+     * std::runtime_error when no single polynomial through k+1 or more
+     * shares stands out
+     */
+    static Result run(const Field& field, const std::vector<Element>& xs, const std::vector<Element>& ys,
+                      std::size_t k, std::size_t threads) {
+        const Tables tables(field, xs, ys, k);
+        const std::uint64_t total = tables.binomial(tables.n, k);
+        if (total == kSaturated) {
+            throw std::invalid_argument("Too many subsets to vote over: C(" + std::to_string(tables.n) +
+                                        ", " + std::to_string(k) + ") exceeds 64 bits");
+        }
+        const std::uint64_t blocks =
+            std::min<std::uint64_t>(total, std::max<std::size_t>(threads, 1) * kBlocksPerThread);
+
+        Shared shared;
+        WorkStealingPool(threads).forEach(static_cast<std::size_t>(blocks), [&](std::size_t block) {
+            const std::uint64_t base = total / blocks, extra = total % blocks;
+            const std::uint64_t begin = block * base + std::min<std::uint64_t>(block, extra);
+            const std::uint64_t end = begin + base + (block < extra ? 1 : 0);
+
+            Walker walker(tables, begin);
+            std::vector<std::pair<std::uint64_t, std::uint64_t>> pending;  // (fingerprint, rank)
+            pending.reserve(kFlush);
+            std::uint64_t rank = begin;
+            for (; rank < end && !shared.stop.load(std::memory_order_relaxed); ++rank) {
+                if (rank != begin) {
+                    walker.next();
+                }
+                const Element secret = walker.secret();
+                if (rank == begin) {
+                    consider(tables, shared, walker, secret);
+                }
+                pending.emplace_back(fingerprint(secret), rank);
+                if (pending.size() == kFlush || rank + 1 == end) {
+                    flush(tables, shared, pending);
+                }
+            }
+            shared.visited += rank - begin;
+        });
+
+        Result& best = shared.best;
+        best.visited = shared.visited;
+        if (best.majority) {
+            return std::move(best);
+        }
+        if (shared.exhausted) {
+            throw std::runtime_error("Subset vote found no majority among " + std::to_string(kMaxTracked) +
+                                     " distinct constants; too many shares are inconsistent");
+        }
+        if (shared.support <= k) {
+            throw std::runtime_error("Subset vote failed: no " + std::to_string(k + 1) +
+                                     " shares lie on a common polynomial");
+        }
+        if (shared.tied) {
+            throw std::runtime_error("Subset vote is tied: several polynomials fit " +
+                                     std::to_string(shared.support) + " of " + std::to_string(tables.n) +
+                                     " shares");
+        }
+        return std::move(best);
+    }
+
+private:
+    static constexpr std::uint64_t kSaturated = std::numeric_limits<std::uint64_t>::max();
+    static constexpr std::size_t kBlocksPerThread = 16;
+    static constexpr std::size_t kFlush = 1024;
+
+    /**
+     * Read-only state shared by all workers
+     */
+    struct Tables {
+        const Field& field;
+        const std::vector<Element>& xs;
+        const std::vector<Element>& ys;
+        std::size_t n;
+        std::size_t k;
+        std::vector<Element> inverses;         // 1/(x_a - x_i) at a·n + i, 1/x_a at a·n + a
+        std::vector<std::uint64_t> binomials;  // C(m, j) at m·(k+1) + j, saturating
+
+        Tables(const Field& f, const std::vector<Element>& xValues, const std::vector<Element>& yValues,
+               std::size_t kValue)
+            : field(f), xs(xValues), ys(yValues), n(xValues.size()), k(kValue) {
+            if (k == 0 || n < k || ys.size() != n) {
+                throw std::invalid_argument("Subset vote needs n >= k >= 1 shares, got n = " +
+                                            std::to_string(n) + ", k = " + std::to_string(k));
+            }
+            inverses.resize(n * n);
+            for (std::size_t a = 0; a < n; ++a) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    Element& value = inverses[a * n + i];
+                    value = a == i ? xs[a] : field.sub(xs[a], xs[i]);
+                    if (field.isZero(value)) {
+                        throw std::invalid_argument(a == i ? "Share " + std::to_string(a) + " has x = 0 mod p"
+                                                           : "Shares " + std::to_string(i) + " and " +
+                                                                 std::to_string(a) + " have the same x mod p");
+                    }
+                }
+            }
+            FieldLagrangeInterpolator<Field>::batchInvert(field, inverses);
+
+            binomials.assign((n + 1) * (k + 1), 0);
+            for (std::size_t m = 0; m <= n; ++m) {
+                binomials[m * (k + 1)] = 1;
+                for (std::size_t j = 1; j <= std::min(m, k); ++j) {
+                    std::uint64_t sum;
+                    if (__builtin_add_overflow(binomial(m - 1, j - 1), binomial(m - 1, j), &sum)) {
+                        sum = kSaturated;
+                    }
+                    binomials[m * (k + 1) + j] = sum;
+                }
+            }
+        }
+
+        const Element& inverse(std::size_t a, std::size_t i) const { return inverses[a * n + i]; }
+
+        std::uint64_t binomial(std::size_t m, std::size_t j) const {
+            if (j > m) {
+                return 0;
+            }
+            return binomials[m * (k + 1) + j];
+        }
+    };
+
+    /**
+     * One subset and its weights, stepped through revolving-door order
+     * (Kreher & Stinson). Shares are t_1 < ... < t_k, numbered from 1.
+     */
+    class Walker {
+    public:
+        Walker(const Tables& tables, std::uint64_t rank)
+            : tables_(tables), t_(tables.k + 2), member_(tables.n), weights_(tables.n) {
+            const Field& field = tables.field;
+            std::size_t x = tables.n;
+            for (std::size_t i = tables.k; i > 0; --i) {
+                while (tables.binomial(x, i) > rank) {
+                    --x;
+                }
+                t_[i] = x + 1;
+                rank = tables.binomial(x + 1, i) - rank - 1;
+            }
+
+            product_ = field.one();
+            for (std::size_t p = 1; p <= tables.k; ++p) {
+                const std::size_t i = t_[p] - 1;
+                member_[i] = 1;
+                product_ = field.mul(product_, tables.xs[i]);
+                weights_[i] = spanWeight(i);
+            }
+        }
+
+        Element secret() const {
+            const Field& field = tables_.field;
+            Element sum = field.zero();
+            for (std::size_t p = 1; p <= tables_.k; ++p) {
+                const std::size_t i = t_[p] - 1;
+                sum = field.add(sum, field.mul(tables_.ys[i], weights_[i]));
+            }
+            return field.mul(product_, sum);
+        }
+
+        // Steps to the next subset: share a leaves, share b joins
+        void next() {
+            const std::size_t k = tables_.k;
+            std::size_t j = 1;
+            t_[k + 1] = tables_.n + 1;
+            while (j <= k && t_[j] == j) {
+                ++j;
+            }
+            const std::size_t low = j > 2 ? j - 2 : 1, high = std::min(j + 1, k);
+            std::array<std::size_t, 4> before{};
+            std::copy(t_.begin() + static_cast<long>(low), t_.begin() + static_cast<long>(high) + 1, before.begin());
+            if ((k - j) % 2 == 1) {
+                if (j == 1) {
+                    --t_[1];
+                } else {
+                    t_[j - 1] = j;
+                    t_[j - 2] = j - 1;
+                }
+            } else if (t_[j + 1] != t_[j] + 1) {
+                t_[j - 1] = t_[j];
+                ++t_[j];
+            } else {
+                t_[j + 1] = t_[j];
+                t_[j] = j;
+            }
+
+            // The window before and after holds the same shares but one
+            const std::size_t width = high - low + 1;
+            auto within = [&](const std::size_t* values, std::size_t value) {
+                return std::find(values, values + width, value) != values + width;
+            };
+            std::size_t a = 0, b = 0;
+            for (std::size_t p = 0; p < width; ++p) {
+                if (!within(&t_[low], before[p])) {
+                    a = before[p] - 1;
+                }
+                if (!within(before.data(), t_[low + p])) {
+                    b = t_[low + p] - 1;
+                }
+            }
+
+            const Field& field = tables_.field;
+            member_[a] = 0;
+            member_[b] = 1;
+            for (std::size_t p = 1; p <= k; ++p) {
+                const std::size_t i = t_[p] - 1;
+                if (i != b) {
+                    weights_[i] = field.mul(weights_[i],
+                                            field.mul(field.sub(tables_.xs[a], tables_.xs[i]), tables_.inverse(b, i)));
+                }
+            }
+            weights_[b] = spanWeight(b);
+            product_ = field.mul(product_, field.mul(tables_.xs[b], tables_.inverse(a, a)));
+        }
+
+        std::vector<std::size_t> subset() const {
+            std::vector<std::size_t> shares;
+            for (std::size_t p = 1; p <= tables_.k; ++p) {
+                shares.push_back(t_[p] - 1);
+            }
+            return shares;
+        }
+
+        /**
+         * Shares off the polynomial through the subset, ascending
+         *   f(x_r) = (-1)^(k-1) · Π_{i∈S} (x_r - x_i) · Σ_{i∈S} y_i w_i x_i / (x_r - x_i)
+         */
+        std::vector<std::size_t> outliers() const {
+            const Field& field = tables_.field;
+            std::vector<std::pair<std::size_t, Element>> scaled;
+            for (std::size_t p = 1; p <= tables_.k; ++p) {
+                const std::size_t i = t_[p] - 1;
+                scaled.emplace_back(i, field.mul(field.mul(tables_.ys[i], weights_[i]), tables_.xs[i]));
+            }
+            std::vector<std::size_t> off;
+            for (std::size_t r = 0; r < tables_.n; ++r) {
+                if (member_[r]) {
+                    continue;
+                }
+                Element span = field.one(), sum = field.zero();
+                for (const auto& [i, value] : scaled) {
+                    span = field.mul(span, field.sub(tables_.xs[r], tables_.xs[i]));
+                    sum = field.add(sum, field.mul(value, tables_.inverse(r, i)));
+                }
+                Element y = field.mul(span, sum);
+                if (tables_.k % 2 == 0) {
+                    y = field.neg(y);
+                }
+                if (!field.equal(y, tables_.ys[r])) {
+                    off.push_back(r);
+                }
+            }
+            return off;
+        }
+
+    private:
+        const Tables& tables_;
+        std::vector<std::size_t> t_;     // t_[1..k] plus scratch at 0 and k+1
+        std::vector<char> member_;       // share i is in the subset
+        std::vector<Element> weights_;   // w_i for the shares in the subset
+        Element product_;                // X_S
+
+        // w_i = Π_{j∈S} 1/(x_j - x_i), where the j = i factor is 1/x_i
+        Element spanWeight(std::size_t i) const {
+            Element weight = tables_.field.one();
+            for (std::size_t p = 1; p <= tables_.k; ++p) {
+                weight = tables_.field.mul(weight, tables_.inverse(t_[p] - 1, i));
+            }
+            return weight;
+        }
+    };
+
+    struct Shared {
+        std::mutex lock;
+        std::unordered_set<std::uint64_t> seen;  // fingerprints of the constants so far
+        std::multimap<Element, std::vector<std::size_t>> checked;  // constant -> outliers of each checked polynomial
+        Result best;
+        std::size_t support = 0;  // shares on the best polynomial
+        bool tied = false;        // another polynomial fits as many shares
+        bool exhausted = false;   // seen outgrew kMaxTracked
+        std::atomic<std::uint64_t> visited{0};
+        std::atomic<bool> stop{false};
+    };
+
+    static std::uint64_t fingerprint(const Element& value) {
+        std::uint64_t hash = 0;
+        for (std::uint64_t limb : value) {
+            hash = (hash ^ limb) * 0x9e3779b97f4a7c15ULL;
+        }
+        return hash;
+    }
+
+    /**
+     * Records a batch of constants; each one met before (or a fingerprint
+     * collision, which only costs a check) gets its polynomial checked
+     */
+    static void flush(const Tables& tables, Shared& shared,
+                      std::vector<std::pair<std::uint64_t, std::uint64_t>>& pending) {
+        std::vector<std::uint64_t> repeats;
+        {
+            std::lock_guard<std::mutex> guard(shared.lock);
+            for (const auto& [hash, rank] : pending) {
+                if (!shared.seen.insert(hash).second) {
+                    repeats.push_back(rank);
+                }
+            }
+            if (shared.seen.size() > kMaxTracked) {
+                shared.exhausted = true;
+                shared.stop = true;
+            }
+        }
+        pending.clear();
+        for (std::uint64_t rank : repeats) {
+            if (shared.stop.load(std::memory_order_relaxed)) {
+                return;
+            }
+            Walker walker(tables, rank);
+            consider(tables, shared, walker, walker.secret());
+        }
+    }
+
+    /**
+     * Checks the subset's polynomial against all shares unless it was
+     * checked already: k shares fix the polynomial, so that is the case
+     * when a checked one with the same constant has none of them as outliers
+     */
+    static void consider(const Tables& tables, Shared& shared, const Walker& walker, const Element& secret) {
+        const std::vector<std::size_t> subset = walker.subset();
+        {
+            std::lock_guard<std::mutex> guard(shared.lock);
+            auto [first, last] = shared.checked.equal_range(secret);
+            for (auto it = first; it != last; ++it) {
+                const std::vector<std::size_t>& off = it->second;
+                if (std::none_of(subset.begin(), subset.end(), [&](std::size_t i) {
+                        return std::binary_search(off.begin(), off.end(), i);
+                    })) {
+                    return;
+                }
+            }
+        }
+        std::vector<std::size_t> outliers = walker.outliers();
+        const std::size_t support = tables.n - outliers.size();
+
+        std::lock_guard<std::mutex> guard(shared.lock);
+        shared.checked.emplace(secret, outliers);
+        if (support > shared.support) {
+            shared.best.secret = secret;
+            shared.best.subset = subset;
+            shared.best.outliers = std::move(outliers);
+            shared.support = support;
+            shared.tied = false;
+            if (2 * support > tables.n + tables.k - 1) {
+                shared.best.majority = true;
+                shared.stop = true;
+            }
+        } else if (support == shared.support && outliers != shared.best.outliers) {
+            shared.tied = true;
+        }
+    }
+};
+
+/**
+ * Ways of reconstructing the constant c from the decoded roots
+ */
+enum class SolverStrategy {
+    ExactLagrange,  // Exact integer Lagrange interpolation at x = 0
+    PrimeField,     // Lagrange interpolation at x = 0 modulo SolverOptions::prime
+    Cramer,         // Legacy long double Cramer's rule on three roots
+    GaoDecoding     // Exact, after Gao decoding modulo 2^64 - 2^32 + 1 drops corrupted roots
+};
+
+/**
+ * Options controlling how a test case is solved
+ */
+struct SolverOptions {
+    SolverStrategy strategy = SolverStrategy::ExactLagrange;
+    BigInt prime;  // Field modulus for SolverStrategy::PrimeField
+    // Locate and skip up to (n-k)/2 corrupted shares (Berlekamp-Welch)
+    bool correctErrors = false;
+    // Majority vote on c over the k-subsets of the shares, skipping outliers
+    bool voteSubsets = false;
+    // Worker threads for voteSubsets
+    std::size_t threads = 1;
+    // Recover every coefficient and check all n roots in one multipoint pass
+    bool fullPolynomial = false;
+    // Lagrange weights shared across solves with the same x's (none: computed every time)
+    std::shared_ptr<LagrangeWeightsCache> weightsCache;
+
+    /**
+     * Parses a prime given as decimal, 0x-prefixed hex, or one of the
+     * named presets "secp256k1" (group order), "mersenne127" (2^127-1) and
+     * "goldilocks" (2^64-2^32+1, an NTT prime)
+     * Throws std::invalid_argument naming --prime when text is none of these.
+     */
+    static BigInt parsePrime(const std::string& text) {
+        if (text == "secp256k1") {
+            return BigInt::fromString("fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141", 16);
+        } else if (text == "mersenne127") {
+            return (BigInt(1) << 127) - BigInt(1);
+        } else if (text == "goldilocks") {
+            return (BigInt(1) << 64) - (BigInt(1) << 32) + BigInt(1);
+        }
+        try {
+            if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+                return BigInt::fromString(std::string_view(text).substr(2), 16);
+            }
+            return BigInt::fromString(text);
+        } catch (const std::invalid_argument&) {
+            throw std::invalid_argument("invalid --prime value: " + text);
+        }
+    }
+};
+
+/**
+ * Polynomial Solver - Finds the constant c = f(0) of the degree k-1
+ * polynomial f through the shares of a test case
+ * 
+ * This program:
+ * 1. Parses JSON files (or a stream) of shares, with n and k from "keys"
+ * 2. Decodes each y-value from its base; x is the share's index
+ * 3. Picks the strategy from SolverOptions: exact Lagrange, modulo a prime,
+ *    error correction (Berlekamp-Welch or Gao), subset voting, or the
+ *    legacy quadratic Cramer's rule
+ * 4. Reconstructs f(0) from k roots and checks the rest against it, or
+ *    recovers every coefficient of f
+ * 5. Uses BigInt, an arbitrary-precision limb integer, so x, y and c have
+ *    no size limit
+ */
+class PolynomialSolver {
+    friend class SolverBenchmarks;
+
+public:
+    // Print per-share parsing details
+    static inline bool verbose = true;
+    // Drop all progress output (batch runs print only one line per file)
+    static inline bool silent = false;
+
+private:
+    /**
+     * Progress output: std::cout, or a per-thread sink that discards
+     * everything when silent
+     */
+    static std::ostream& log() {
+        if (!silent) {
+            return std::cout;
+        }
+        struct NullBuffer : std::streambuf {
+            int overflow(int c) override { return traits_type::not_eof(c); }
+            std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+        };
+        static thread_local NullBuffer buffer;
+        static thread_local std::ostream sink(&buffer);
+        return sink;
+    }
+
+    /**
+     * Represents a single root point (x, y) where:
+     * x = the x-coordinate (input value)
+     * y = the y-coordinate (decoded from base-encoded string)
+     */
+    struct Root {
+        BigInt x; // x-coordinate (usually the index from JSON)
+        BigInt y; // y-coordinate (decoded from base-encoded value)
+        
+        Root(BigInt x_val, BigInt y_val) : x(std::move(x_val)), y(std::move(y_val)) {}
+        
+        std::string toString() const {
+            return "(" + x.toString() + ", " + y.toString() + ")";
+        }
+    };
+    
+    // Root lists built while solving take their memory from the current FileArena
+    using Roots = std::pmr::vector<Root>;
+    
+    /**
+     * Container for a complete test case
+     * Holds the metadata (n, k) and all the roots
+     */
+    struct TestCase {
+        int n;                    // Number of roots
+        int k;                    // Parameter k
+        Roots roots;              // All decoded roots
+        
+        TestCase(int n_val, int k_val, Roots roots_val) 
+            : n(n_val), k(k_val), roots(std::move(roots_val)) {}
+    };
+
+public:
+    /**
+     * f(x) = Σ numerators[j] · x^j / denominator, constant term first, in
+     * lowest terms (denominator 1 modulo p or for an integer polynomial)
+     */
+    struct Coefficients {
+        std::vector<BigInt> numerators;
+        BigInt denominator = BigInt(1);
+    };
+
+    /**
+     * Result class to hold the processed test case data
+     * Contains n, k, decoded roots, and calculated constant c
+     * Made inside a FileArena::Scope, its roots and spilled BigInts live in
+     * that arena and must be destroyed before the scope ends.
+     */
+    struct ProcessResult {
+        int n;                    // Number of roots
+        int k;                    // Parameter k from JSON
+        Roots roots;              // List of decoded (x, y) coordinates
+        BigInt constantC;         // Calculated constant c
+        std::vector<std::size_t> corrupted;  // Positions in roots found corrupted (error correction only)
+        Coefficients coefficients;           // The whole polynomial (SolverOptions::fullPolynomial only)
+        
+        ProcessResult(int n_val, int k_val, Roots roots_val, BigInt constantC_val)
+            : n(n_val), k(k_val), roots(std::move(roots_val)), constantC(std::move(constantC_val)) {}
+    };
+
+    /**
+     * Main entry point for processing a single test case file
+     * Inside a FileArena::Scope the result is valid only until the scope
+     * ends; to keep it longer, call this under FileArena::Suspend (or copy
+     * what is needed under one) so it lands on the heap.
+     */
+    static ProcessResult processTestCase(const std::string& filename,
+                                         const SolverOptions& options = SolverOptions()) {
+        TestCase testCase = readTestCase(filename);
+        std::vector<std::size_t> corrupted;
+        Coefficients coefficients;
+        BigInt constantC = solvePolynomial(testCase, options, &corrupted, &coefficients);
+        ProcessResult result(testCase.n, testCase.k, std::move(testCase.roots), std::move(constantC));
+        result.corrupted = std::move(corrupted);
+        result.coefficients = std::move(coefficients);
+        return result;
+    }
+
+    /**
+     * c = f(0) for many secrets whose shares all sit at the same x's
+     * 
+     * ys is column-major, secrets × k: share i of secret s is
+     * ys[i·secrets + s]. The weights are computed (or taken from
+     * options.weightsCache) once, then BatchLagrangeKernel applies them to
+     * every secret: exactly, or modulo options.prime for the PrimeField
+     * strategy, where primes below 2^30 take the eight-lane 32-bit field.
+     * Throws std::invalid_argument for other strategies or mismatched
+     * sizes, and std::runtime_error when an exact secret is not an integer.
+     */
+    static std::vector<BigInt> reconstructBatch(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys,
+                                                std::size_t secrets, const SolverOptions& options = SolverOptions()) {
+        if (xs.empty()) {
+            throw std::invalid_argument("Cannot interpolate without points");
+        }
+        if (ys.size() != xs.size() * secrets) {
+            throw std::invalid_argument("Expected " + std::to_string(xs.size()) + " x " + std::to_string(secrets) +
+                                        " y-values, got " + std::to_string(ys.size()));
+        }
+        LagrangeWeightsCache* cache = options.weightsCache.get();
+        std::vector<BigInt> constants(secrets);
+        
+        if (options.strategy == SolverStrategy::PrimeField) {
+            if (options.prime.isZero()) {
+                throw std::invalid_argument("Prime field strategy needs a prime modulus");
+            }
+            auto solve = [&](const auto& field) {
+                using Field = std::decay_t<decltype(field)>;
+                using Element = typename Field::Element;
+                
+                if (!field.isProbablePrime()) {
+                    throw std::invalid_argument("Field modulus is not prime: " + options.prime.toString());
+                }
+                const std::vector<Element> weights = fieldWeights(field, xs, cache);
+                std::vector<Element> fieldYs(ys.size()), sums(secrets);
+                for (std::size_t i = 0; i < ys.size(); ++i) {
+                    fieldYs[i] = field.fromBigInt(ys[i]);
+                }
+                BatchLagrangeKernel<Field>::run(field, weights, fieldYs.data(), secrets, sums.data(), options.threads);
+                for (std::size_t s = 0; s < secrets; ++s) {
+                    constants[s] = field.toBigInt(sums[s]);
+                }
+                return 0;
+            };
+            if (options.prime.bitLength() <= 30 && !options.prime.isNegative()) {
+                solve(MontgomeryField32(static_cast<std::uint32_t>(options.prime.toInt64())));
+            } else {
+                withMontgomeryField(options.prime, solve);
+            }
+            return constants;
+        }
+        if (options.strategy != SolverStrategy::ExactLagrange || options.correctErrors || options.voteSubsets ||
+            options.fullPolynomial) {
+            throw std::invalid_argument("Batch reconstruction needs the exact or prime field strategy "
+                                        "without error correction");
+        }
+        
+        const auto weights = exactWeights(xs, cache);
+        BatchLagrangeKernel<IntegerRing>::run(IntegerRing(), weights->numerators, ys.data(), secrets,
+                                              constants.data(), options.threads);
+        for (std::size_t s = 0; s < secrets; ++s) {
+            BigInt quotient, remainder;
+            BigInt::divMod(constants[s], weights->denominator, quotient, remainder);
+            if (!remainder.isZero()) {
+                throw std::runtime_error("Secret " + std::to_string(s) + " does not interpolate to an integer: f(0) = " +
+                                         constants[s].toString() + "/" + weights->denominator.toString());
+            }
+            constants[s] = std::move(quotient);
+        }
+        return constants;
+    }
+
+    /**
+     * Reconstructs c from a test case read as a stream ("-" for stdin)
+     * 
+     * Shares are decoded as they arrive. The first k go into an online
+     * interpolator, so the weight work overlaps reading; as soon as the
+     * k-th is in, c is read off, and every later share is checked
+     * against that polynomial and dropped. Peak memory is k shares plus one
+     * JSON member, except that shares arriving before "keys" are held until
+     * k is known.
+     */
+    static BigInt streamTestCase(const std::string& filename,
+                                 const SolverOptions& options = SolverOptions()) {
+        if (options.strategy != SolverStrategy::ExactLagrange) {
+            throw std::invalid_argument("Streaming input supports exact reconstruction only");
+        }
+        if (options.correctErrors || options.voteSubsets) {
+            throw std::invalid_argument("Streaming input does not support error correction");
+        }
+        if (options.fullPolynomial) {
+            throw std::invalid_argument("Streaming input recovers the constant only");
+        }
+        
+        struct StreamingReconstructor {
+            std::size_t k = 0;
+            bool haveKeys = false;
+            Roots early;                 // shares read before "keys"
+            OnlineLagrangeInterpolator accumulator;  // the first k shares
+            bool solved = false;
+            BigInt c;
+            std::size_t verified = 0;
+            std::size_t rejected = 0;
+            
+            void keys(const SimpleJsonParser::Keys& keys) {
+                int n = parseInt(keys.n, "n");
+                int kValue = parseInt(keys.k, "k");
+                log() << "Streaming test case: n=" << n << ", k=" << kValue << std::endl;
+                if (kValue < 1) {
+                    throw std::invalid_argument("k must be at least 1, got " + std::to_string(kValue));
+                }
+                k = static_cast<std::size_t>(kValue);
+                haveKeys = true;
+                
+                for (Root& root : early) {
+                    offer(std::move(root));
+                }
+                Roots().swap(early);
+            }
+            
+            void share(const SimpleJsonParser::ShareEntry& share) {
+                Root root(parseIndex(share.index), decodeFromBase(share.value, share.base));
+                if (haveKeys) {
+                    offer(std::move(root));
+                } else {
+                    early.push_back(std::move(root));
+                }
+            }
+            
+            // Interpolation shares go into the accumulator as they arrive
+            void offer(Root root) {
+                if (solved) {
+                    check(root);
+                    return;
+                }
+                accumulator.add(root.x, std::move(root.y));
+                if (accumulator.size() == k) {
+                    log() << "Interpolating exactly through " << k << " roots (degree "
+                              << k - 1 << ")" << std::endl;
+                    c = accumulator.secret();
+                    log() << "Calculated c (exact): " << c << std::endl;
+                    solved = true;
+                }
+            }
+            
+            void check(const Root& root) {
+                if (liesOnPolynomial(accumulator.xs(), accumulator.ys(), root)) {
+                    ++verified;
+                    if (verbose) {
+                        log() << "✓ Root " << root.toString() << " verified" << std::endl;
+                    }
+                } else {
+                    ++rejected;
+                    log() << "Warning: Root " << root.toString()
+                              << " does not lie on the interpolated polynomial" << std::endl;
+                }
+            }
+        } reconstructor;
+        
+        if (filename == "-") {
+            SimpleJsonParser::parseStream(std::cin, reconstructor);
+        } else {
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Cannot open file: " + filename);
+            }
+            SimpleJsonParser::parseStream(file, reconstructor);
+        }
+        
+        if (!reconstructor.solved) {
+            throw std::invalid_argument("Need k = " + std::to_string(reconstructor.k) + " roots, only " +
+                                        std::to_string(reconstructor.accumulator.size() +
+                                                       reconstructor.early.size()) + " available");
+        }
+        if (reconstructor.verified + reconstructor.rejected > 0) {
+            log() << "Verified " << reconstructor.verified << " of "
+                      << reconstructor.verified + reconstructor.rejected << " extra roots" << std::endl;
+        }
+        return reconstructor.c;
+    }
+
+    /**
+     * Main method - runs both test cases automatically
+     */
+    static void runTests(const SolverOptions& options = SolverOptions()) {
+        try {
+            // Test case 1
+            log() << "=== Test Case 1 ===" << std::endl;
+            TestCase testCase1 = readTestCase("test_case_1.json");
+            log() << "Found " << testCase1.roots.size() << " roots:" << std::endl;
+            for (const auto& root : testCase1.roots) {
+                log() << "  " << root.toString() << std::endl;
+            }
+            
+            BigInt constantC1 = solvePolynomial(testCase1, options);
+            log() << "Constant c for test case 1: " << constantC1 << std::endl;
+            
+            log() << "\n=== Test Case 2 ===" << std::endl;
+            TestCase testCase2 = readTestCase("test_case_2.json");
+            log() << "Found " << testCase2.roots.size() << " roots:" << std::endl;
+            for (size_t i = 0; i < std::min(testCase2.roots.size(), size_t(5)); ++i) {
+                log() << "  " << testCase2.roots[i].toString() << std::endl;
+            }
+            if (testCase2.roots.size() > 5) {
+                log() << "  ... and " << (testCase2.roots.size() - 5) << " more roots" << std::endl;
+            }
+            
+            BigInt constantC2 = solvePolynomial(testCase2, options);
+            log() << "Constant c for test case 2: " << constantC2 << std::endl;
+            
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    }
+
+private:
+    /**
+     * Reads and parses a JSON test case file
+     * 
+     * JSON Structure:
+     * {
+     *   "keys": {"n": 4, "k": 3},
+     *   "1": {"base": "10", "value": "4"},
+     *   "2": {"base": "2", "value": "111"},
+     *   ...
+     * }
+     * 
+     * Every share becomes a Root as the parser reaches it: x is the share's
+     * own index (any size), y its decoded value. Roots keep file order.
+     */
+    static TestCase readTestCase(const std::string& filename) {
+        SimpleJsonParser::Input input(filename);
+        
+        // Collects roots straight from the parser, one pass, no per-share strings
+        struct RootCollector {
+            int n = 0;
+            int k = 0;
+            Roots roots{FileArena::resource()};
+            
+            void keys(const SimpleJsonParser::Keys& keys) {
+                n = parseInt(keys.n, "n");  // Number of roots
+                k = parseInt(keys.k, "k");  // Parameter k
+                log() << "Parsing test case: n=" << n << ", k=" << k << std::endl;
+                roots.reserve(static_cast<std::size_t>(std::max(n, 0)));
+            }
+            
+            void share(const SimpleJsonParser::ShareEntry& share) {
+                BigInt x = parseIndex(share.index);            // x = the share's index
+                BigInt y = decodeFromBase(share.value, share.base);  // y = decoded value
+                
+                if (verbose) {
+                    log() << "Processing index " << share.index << ": base=" << share.base
+                              << ", value=" << share.value << std::endl;
+                    log() << "  Decoded: " << share.value << " (base " << share.base
+                              << ") = " << y << " (decimal)" << std::endl;
+                }
+                
+                roots.emplace_back(std::move(x), std::move(y));
+            }
+        } collector;
+        
+        SimpleJsonParser::parse(input.text(), collector);
+        
+        log() << "Successfully parsed " << collector.roots.size() << " roots" << std::endl;
+        return TestCase(collector.n, collector.k, std::move(collector.roots));
+    }
+    
+    /**
+     * Parses a signed decimal int such as n, k or a base
+     */
+    static int parseInt(std::string_view text, const char* what) {
+        std::string_view digits = text;
+        bool negative = !digits.empty() && digits[0] == '-';
+        if (negative) {
+            digits.remove_prefix(1);
+        }
+        long long value = 0;
+        for (char c : digits) {
+            if (c < '0' || c > '9' || value > std::numeric_limits<int>::max()) {
+                value = -1;
+                break;
+            }
+            value = value * 10 + (c - '0');
+        }
+        if (digits.empty() || value < 0 || value > std::numeric_limits<int>::max()) {
+            throw std::invalid_argument(std::string("Invalid ") + what + ": \"" + std::string(text) + "\"");
+        }
+        return static_cast<int>(negative ? -value : value);
+    }
+    
+    /**
+     * Parses a share index into its x-coordinate
+     * Indices of up to 18 digits take a plain 64-bit path; longer ones
+     * become big integers.
+     */
+    static BigInt parseIndex(std::string_view index) {
+        if (!index.empty() && index.size() <= 18 &&
+            std::all_of(index.begin(), index.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            std::uint64_t value = 0;
+            for (char c : index) {
+                value = value * 10 + static_cast<std::uint64_t>(c - '0');
+            }
+            return BigInt(value);
+        }
+        try {
+            return BigInt::fromString(index);
+        } catch (const std::invalid_argument&) {
+            throw std::invalid_argument("Invalid share index: \"" + std::string(index) + "\"");
+        }
+    }
+    
+    /**
+     * Main polynomial solving logic
+     * 
+     * The shares lie on a polynomial of degree k-1, so exactly k roots
+     * determine it:
+     * 1. Interpolate exactly through the first k roots to get c = f(0)
+     * 2. Check the remaining n-k roots against the same polynomial
+     * 
+     * The legacy Cramer strategy keeps the old quadratic model.
+     * 
+     * With options.correctErrors or the GaoDecoding strategy, all n roots are
+     * decoded together instead and up to (n-k)/2 corrupted ones are located
+     * and left out; their positions in testCase.roots go to corrupted when
+     * it is given. With options.voteSubsets the k-subsets of the roots vote
+     * on c, and the outliers are reported the same way.
+     * 
+     * With options.fullPolynomial every coefficient is recovered (into
+     * coefficients when given) and roots off the polynomial are reported
+     * like corrupted ones.
+     */
+    static BigInt solvePolynomial(const TestCase& testCase,
+                                  const SolverOptions& options = SolverOptions(),
+                                  std::vector<std::size_t>* corrupted = nullptr,
+                                  Coefficients* coefficients = nullptr) {
+        const Roots& roots = testCase.roots;
+        
+        if (roots.empty()) {
+            throw std::invalid_argument("No roots provided");
+        }
+        
+        log() << "Solving polynomial with " << roots.size() << " roots" << std::endl;
+        
+        const bool gao = options.strategy == SolverStrategy::GaoDecoding;
+        if ((options.correctErrors || gao) && options.voteSubsets) {
+            throw std::invalid_argument("Error correction and subset voting cannot be combined");
+        }
+        if (options.fullPolynomial && (options.correctErrors || gao || options.voteSubsets)) {
+            throw std::invalid_argument("Coefficient recovery cannot be combined with error correction");
+        }
+        if (options.strategy == SolverStrategy::Cramer) {
+            if (options.correctErrors || options.voteSubsets) {
+                throw std::invalid_argument("Error correction needs the exact or prime field strategy");
+            }
+            if (options.fullPolynomial) {
+                throw std::invalid_argument("Coefficient recovery needs the exact or prime field strategy");
+            }
+            // Legacy model: f(x) = ax² + bx + c from the first three roots
+            if (roots.size() >= 3) {
+                return solveSystemOfEquations(roots);
+            }
+            return solveSimplePolynomial(roots);
+        }
+        
+        if (testCase.k < 1) {
+            throw std::invalid_argument("k must be at least 1, got " + std::to_string(testCase.k));
+        }
+        const std::size_t k = static_cast<std::size_t>(testCase.k);
+        if (roots.size() < k) {
+            throw std::invalid_argument("Need k = " + std::to_string(k) + " roots, only " +
+                                        std::to_string(roots.size()) + " available");
+        }
+        
+        if (options.correctErrors || gao) {
+            return solveWithErrorCorrection(roots, k, options, corrupted);
+        }
+        if (options.voteSubsets) {
+            return solveBySubsetVote(roots, k, options, corrupted);
+        }
+        if (options.fullPolynomial) {
+            return solveFullPolynomial(roots, k, options, corrupted, coefficients);
+        }
+        
+        Roots used(roots.begin(), roots.begin() + static_cast<long>(k), FileArena::resource());
+        Roots extra(roots.begin() + static_cast<long>(k), roots.end(), FileArena::resource());
+        if (options.strategy == SolverStrategy::PrimeField) {
+            return solvePrimeField(used, extra, options.prime, options.weightsCache.get());
+        }
+        BigInt c = solveExactLagrange(used, options.weightsCache.get());
+        verifyExtraRoots(used, extra);
+        return c;
+    }
+    
+    /**
+     * Solves for c = f(0) by exact Lagrange interpolation through the given roots
+     * 
+     * k roots give the unique polynomial of degree k-1 through them. Uses
+     * integer weights over a common denominator, so the result is bit-exact
+     * no matter how large the y-values are. With a cache the weights for
+     * these x's are computed once and reused.
+     */
+    static BigInt solveExactLagrange(const Roots& roots, LagrangeWeightsCache* cache = nullptr) {
+        std::vector<BigInt> xs, ys;
+        splitRoots(roots, xs, ys);
+        
+        log() << "Interpolating exactly through " << roots.size() << " roots (degree "
+                  << roots.size() - 1 << ")" << std::endl;
+        
+        BigInt c = LagrangeInterpolator::evaluateAtZero(*exactWeights(xs, cache), ys);
+        
+        log() << "Calculated c (exact): " << c << std::endl;
+        
+        return c;
+    }
+    
+    /**
+     * Checks roots that were not used for interpolation against the
+     * polynomial through the used ones
+     * 
+     * f(x_r) is f(0) of the same shares shifted by -x_r, compared exactly as
+     * D · y_r == Σ w_i · y_i so a non-integer f(x_r) is handled too.
+     */
+    static void verifyExtraRoots(const Roots& used, const Roots& extra) {
+        if (extra.empty()) {
+            return;
+        }
+        log() << "Verifying solution..." << std::endl;
+        
+        std::vector<BigInt> xs, ys;
+        splitRoots(used, xs, ys);
+        for (const Root& root : extra) {
+            if (!liesOnPolynomial(xs, ys, root)) {
+                log() << "Warning: Root " << root.toString()
+                          << " does not lie on the interpolated polynomial" << std::endl;
+            } else if (verbose) {
+                log() << "✓ Root " << root.toString() << " verified" << std::endl;
+            }
+        }
+    }
+    
+    /**
+     * Whether root lies on the polynomial through (xs, ys)
+     */
+    static bool liesOnPolynomial(const std::vector<BigInt>& xs, const std::vector<BigInt>& ys,
+                                 const Root& root) {
+        std::vector<BigInt> shifted(xs.size());
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+            shifted[i] = xs[i] - root.x;
+        }
+        LagrangeInterpolator::Weights weights = LagrangeInterpolator::computeWeights(shifted);
+        return LagrangeInterpolator::weightedSum(weights, ys) == root.y * weights.denominator;
+    }
+    
+    /**
+     * Solves for c = f(0) mod p by Lagrange interpolation over GF(p)
+     * 
+     * Field elements use Montgomery form sized to the prime (up to 512
+     * bits). All basis denominators share one modular inversion, or with a
+     * cache the weights for these x's come reduced from it. Extra roots are
+     * checked modulo p.
+     */
+    static BigInt solvePrimeField(const Roots& used, const Roots& extra,
+                                  const BigInt& prime, LagrangeWeightsCache* cache = nullptr) {
+        if (prime.isZero()) {
+            throw std::invalid_argument("Prime field strategy needs a prime modulus");
+        }
+        
+        return withMontgomeryField(prime, [&](const auto& field) {
+            using Field = std::decay_t<decltype(field)>;
+            using Interpolator = FieldLagrangeInterpolator<Field>;
+            using Element = typename Field::Element;
+            
+            if (!field.isProbablePrime()) {
+                throw std::invalid_argument("Field modulus is not prime: " + prime.toString());
+            }
+            log() << "Interpolating " << used.size() << " roots modulo a " << prime.bitLength()
+                      << "-bit prime (" << Field::kLimbs << "-limb Montgomery)" << std::endl;
+            
+            std::vector<BigInt> xs;
+            std::vector<Element> ys;
+            for (const Root& root : used) {
+                xs.push_back(root.x);
+                ys.push_back(field.fromBigInt(root.y));
+            }
+            BigInt c = field.toBigInt(Interpolator::dot(field, fieldWeights(field, xs, cache), ys));
+            log() << "Calculated c (mod p): " << c << std::endl;
+            
+            if (!extra.empty()) {
+                log() << "Verifying solution modulo p..." << std::endl;
+            }
+            for (const Root& root : extra) {
+                std::vector<BigInt> shifted(xs.size());
+                for (std::size_t i = 0; i < xs.size(); ++i) {
+                    shifted[i] = xs[i] - root.x;
+                }
+                Element expected = Interpolator::dot(field, fieldWeights(field, shifted), ys);
+                if (!field.equal(expected, field.fromBigInt(root.y))) {
+                    log() << "Warning: Root " << root.toString()
+                              << " does not lie on the interpolated polynomial mod p" << std::endl;
+                } else if (verbose) {
+                    log() << "✓ Root " << root.toString() << " verified mod p" << std::endl;
+                }
+            }
+            return c;
+        });
+    }
+    
+    /**
+     * Solves for c while locating corrupted roots (Berlekamp-Welch, or Gao
+     * for the GaoDecoding strategy)
+     * 
+     * Decoding runs modulo the PrimeField prime, or for exact reconstruction
+     * modulo 2^127 - 1, where a wrong root can only look right by a 2^-127
+     * accident. Gao decoding needs an NTT prime and uses 2^64 - 2^32 + 1,
+     * trading a 2^-64 accident for O(n log² n) instead of O(n³). The exact c
+     * is then interpolated through k good roots and every other good root
+     * is checked exactly, so the answer is never silently wrong.
+     */
+    static BigInt solveWithErrorCorrection(const Roots& roots, std::size_t k,
+                                           const SolverOptions& options, std::vector<std::size_t>* corrupted) {
+        const bool gao = options.strategy == SolverStrategy::GaoDecoding;
+        const bool exact = gao || options.strategy == SolverStrategy::ExactLagrange;
+        const BigInt prime = gao ? SolverOptions::parsePrime("goldilocks")
+                           : exact ? SolverOptions::parsePrime("mersenne127") : options.prime;
+        if (prime.isZero()) {
+            throw std::invalid_argument("Prime field strategy needs a prime modulus");
+        }
+        
+        std::vector<std::size_t> bad;
+        BigInt c = withMontgomeryField(prime, [&](const auto& field) {
+            using Field = std::decay_t<decltype(field)>;
+            using Element = typename Field::Element;
+            
+            if (!exact && !field.isProbablePrime()) {
+                throw std::invalid_argument("Field modulus is not prime: " + prime.toString());
+            }
+            log() << "Decoding " << roots.size() << " roots modulo a " << prime.bitLength()
+                      << "-bit prime, correcting up to " << (roots.size() - k) / 2 << " corrupted" << std::endl;
+            
+            std::vector<Element> xs, ys;
+            for (const Root& root : roots) {
+                xs.push_back(field.fromBigInt(root.x));
+                ys.push_back(field.fromBigInt(root.y));
+            }
+            auto decoded = gao ? GaoDecoder<Field>::decode(field, xs, ys, k)
+                               : BerlekampWelchDecoder<Field>::decode(field, xs, ys, k);
+            bad = std::move(decoded.corrupted);
+            return field.toBigInt(decoded.coefficients[0]);
+        });
+        for (std::size_t i : bad) {
+            log() << "Warning: Root " << roots[i].toString() << " is corrupted, skipping it" << std::endl;
+        }
+        log() << "✓ " << roots.size() - bad.size() << " of " << roots.size()
+                  << " roots lie on one polynomial" << std::endl;
+        
+        if (exact) {
+            c = solveExactSkipping(roots, k, bad);
+        } else {
+            log() << "Calculated c (mod p): " << c << std::endl;
+        }
+        if (corrupted) {
+            *corrupted = std::move(bad);
+        }
+        return c;
+    }
+    
+    /**
+     * Solves for c by a majority vote of the k-subsets of the roots
+     * 
+     * Like error correction, the vote runs modulo the PrimeField prime or,
+     * for exact reconstruction, modulo 2^127 - 1 followed by exact
+     * interpolation through k roots of the winning polynomial. Unlike
+     * Berlekamp-Welch it is not limited to (n-k)/2 outliers, but the work
+     * grows with C(n, k) unless a majority shows up early.
+     */
+    static BigInt solveBySubsetVote(const Roots& roots, std::size_t k,
+                                    const SolverOptions& options, std::vector<std::size_t>* outliers) {
+        const bool exact = options.strategy == SolverStrategy::ExactLagrange;
+        const BigInt prime = exact ? SolverOptions::parsePrime("mersenne127") : options.prime;
+        if (prime.isZero()) {
+            throw std::invalid_argument("Prime field strategy needs a prime modulus");
+        }
+        
+        std::vector<std::size_t> off;
+        BigInt c = withMontgomeryField(prime, [&](const auto& field) {
+            using Field = std::decay_t<decltype(field)>;
+            using Element = typename Field::Element;
+            
+            if (!exact && !field.isProbablePrime()) {
+                throw std::invalid_argument("Field modulus is not prime: " + prime.toString());
+            }
+            log() << "Voting over the " << k << "-subsets of " << roots.size() << " roots modulo a "
+                      << prime.bitLength() << "-bit prime on " << options.threads << " thread(s)" << std::endl;
+            
+            std::vector<Element> xs, ys;
+            for (const Root& root : roots) {
+                xs.push_back(field.fromBigInt(root.x));
+                ys.push_back(field.fromBigInt(root.y));
+            }
+            auto vote = SubsetVote<Field>::run(field, xs, ys, k, options.threads);
+            log() << (vote.majority ? "Majority" : "Plurality") << " found after " << vote.visited
+                      << " subsets" << std::endl;
+            off = std::move(vote.outliers);
+            return field.toBigInt(vote.secret);
+        });
+        for (std::size_t i : off) {
+            log() << "Warning: Root " << roots[i].toString() << " is an outlier, skipping it" << std::endl;
+        }
+        log() << "✓ " << roots.size() - off.size() << " of " << roots.size()
+                  << " roots lie on one polynomial" << std::endl;
+        
+        if (exact) {
+            c = solveExactSkipping(roots, k, off);
+        } else {
+            log() << "Calculated c (mod p): " << c << std::endl;
+        }
+        if (outliers) {
+            *outliers = std::move(off);
+        }
+        return c;
+    }
+    
+    /**
+     * Exact c through the first k roots not in skipped (ascending); every
+     * later root not in skipped must lie exactly on the same polynomial
+     */
+    static BigInt solveExactSkipping(const Roots& roots, std::size_t k,
+                                     const std::vector<std::size_t>& skipped) {
+        Roots used(FileArena::resource()), extra(FileArena::resource());
+        for (std::size_t i = 0, next = 0; i < roots.size(); ++i) {
+            if (next < skipped.size() && skipped[next] == i) {
+                ++next;
+            } else {
+                (used.size() < k ? used : extra).push_back(roots[i]);
+            }
+        }
+        BigInt c = solveExactLagrange(used);
+        std::vector<BigInt> xs, ys;
+        splitRoots(used, xs, ys);
+        for (const Root& root : extra) {
+            if (!liesOnPolynomial(xs, ys, root)) {
+                throw std::runtime_error("Root " + root.toString() +
+                                         " agrees modulo p but not exactly; shares are inconsistent");
+            }
+        }
+        return c;
+    }
+    
+    /**
+     * Recovers every coefficient of the polynomial through the first k roots
+     * and checks all n roots against it in one pass
+     * 
+     * Modulo a prime both run on subproduct trees (PolynomialArithmetic):
+     * interpolation and multipoint evaluation in O(M(n) log n) instead of
+     * O(k²) per extra root. Exactly, with g = Π (x - x_i) and D the common
+     * denominator of LagrangeInterpolator,
+     *   D · f = Σ y_i · (D / g'(x_i)) · g / (x - x_i)
+     * has integer coefficients, combined up the same tree with
+     * CrtPolynomialMultiplier products. Over Z a remainder tree gains
+     * log|x| bits per degree at every level, so the exact check is Horner on
+     * D · f, and a root lies on f when (D · f)(x_r) = D · y_r.
+     */
+    static BigInt solveFullPolynomial(const Roots& roots, std::size_t k, const SolverOptions& options,
+                                      std::vector<std::size_t>* offCurve, Coefficients* coefficients) {
+        const bool exact = options.strategy == SolverStrategy::ExactLagrange;
+        std::vector<BigInt> xs, ys;
+        splitRoots(roots, xs, ys);
+        Coefficients fit;
+        std::vector<std::size_t> off;
+        
+        if (exact) {
+            log() << "Recovering all " << k << " coefficients exactly by subproduct tree" << std::endl;
+            const IntegerRing ring;
+            const PolynomialArithmetic<IntegerRing> arithmetic(ring);
+            const std::vector<BigInt> usedXs(xs.begin(), xs.begin() + static_cast<long>(k));
+            const BigInt denominator = LagrangeInterpolator::commonDenominator(usedXs);
+            std::vector<BigInt> weights = LagrangeInterpolator::basisDenominators(usedXs);
+            for (std::size_t i = 0; i < k; ++i) {
+                weights[i] = ys[i] * (denominator / weights[i]);
+            }
+            std::vector<BigInt> scaled = arithmetic.linearCombination(arithmetic.subproductTree(usedXs), weights);
+            
+            for (std::size_t r = 0; r < roots.size(); ++r) {
+                BigInt value;
+                for (std::size_t j = scaled.size(); j-- > 0;) {
+                    value *= xs[r];
+                    value += scaled[j];
+                }
+                if (value != ys[r] * denominator) {
+                    off.push_back(r);
+                }
+            }
+            
+            BigInt divisor = denominator;
+            for (std::size_t j = 0; j < scaled.size() && divisor != BigInt(1); ++j) {
+                divisor = BigInt::gcd(divisor, scaled[j]);
+            }
+            scaled.resize(k);
+            for (const BigInt& coefficient : scaled) {
+                fit.numerators.push_back(coefficient / divisor);
+            }
+            fit.denominator = denominator / divisor;
+        } else {
+            if (options.prime.isZero()) {
+                throw std::invalid_argument("Prime field strategy needs a prime modulus");
+            }
+            withMontgomeryField(options.prime, [&](const auto& field) {
+                using Field = std::decay_t<decltype(field)>;
+                using Element = typename Field::Element;
+                
+                if (!field.isProbablePrime()) {
+                    throw std::invalid_argument("Field modulus is not prime: " + options.prime.toString());
+                }
+                log() << "Recovering all " << k << " coefficients modulo a " << options.prime.bitLength()
+                          << "-bit prime by subproduct tree" << std::endl;
+                const PolynomialArithmetic<Field> arithmetic(field);
+                std::vector<Element> fieldXs, fieldYs;
+                for (std::size_t r = 0; r < roots.size(); ++r) {
+                    fieldXs.push_back(field.fromBigInt(xs[r]));
+                    fieldYs.push_back(field.fromBigInt(ys[r]));
+                }
+                const std::vector<Element> usedXs(fieldXs.begin(), fieldXs.begin() + static_cast<long>(k));
+                const std::vector<Element> usedYs(fieldYs.begin(), fieldYs.begin() + static_cast<long>(k));
+                std::vector<Element> f = arithmetic.interpolate(arithmetic.subproductTree(usedXs), usedXs, usedYs);
+                
+                const std::vector<Element> values = arithmetic.evaluate(f, arithmetic.subproductTree(fieldXs), fieldXs);
+                for (std::size_t r = 0; r < roots.size(); ++r) {
+                    if (!field.equal(values[r], fieldYs[r])) {
+                        off.push_back(r);
+                    }
+                }
+                f.resize(k, field.zero());
+                for (const Element& coefficient : f) {
+                    fit.numerators.push_back(field.toBigInt(coefficient));
+                }
+            });
+        }
+        
+        if (verbose) {
+            for (std::size_t j = 0; j < k; ++j) {
+                log() << "  x^" << j << ": " << fit.numerators[j]
+                      << (fit.denominator == BigInt(1) ? "" : " / " + fit.denominator.toString()) << std::endl;
+            }
+        }
+        for (std::size_t r : off) {
+            log() << "Warning: Root " << roots[r].toString() << " does not lie on the interpolated polynomial"
+                  << (exact ? "" : " mod p") << std::endl;
+        }
+        log() << "✓ " << roots.size() - off.size() << " of " << roots.size()
+                  << " roots lie on the polynomial" << (exact ? "" : " mod p") << std::endl;
+        
+        BigInt c, remainder;
+        BigInt::divMod(fit.numerators[0], fit.denominator, c, remainder);
+        if (!remainder.isZero()) {
+            throw std::runtime_error("Shares do not interpolate to an integer constant: f(0) = " +
+                                     fit.numerators[0].toString() + "/" + fit.denominator.toString());
+        }
+        log() << "Calculated c (" << (exact ? "exact" : "mod p") << "): " << c << std::endl;
+        if (offCurve) {
+            *offCurve = std::move(off);
+        }
+        if (coefficients) {
+            *coefficients = std::move(fit);
+        }
+        return c;
+    }
+    
+    /**
+     * Exact Lagrange weights, from the cache when there is one
+     */
+    static std::shared_ptr<const LagrangeInterpolator::Weights> exactWeights(const std::vector<BigInt>& xs,
+                                                                             LagrangeWeightsCache* cache) {
+        if (!cache) {
+            return std::make_shared<const LagrangeInterpolator::Weights>(LagrangeInterpolator::computeWeights(xs));
+        }
+        return cache->get(BigInt(), xs, [](const std::vector<BigInt>& sorted) {
+            return LagrangeInterpolator::computeWeights(sorted);
+        });
+    }
+    
+    /**
+     * Field Lagrange weights, from the cache when there is one (stored as
+     * canonical residues)
+     */
+    template <typename Field>
+    static std::vector<typename Field::Element> fieldWeights(const Field& field, const std::vector<BigInt>& xs,
+                                                             LagrangeWeightsCache* cache) {
+        if (!cache) {
+            return fieldWeights(field, xs);
+        }
+        auto cached = cache->get(field.modulus(), xs, [&](const std::vector<BigInt>& sorted) {
+            LagrangeInterpolator::Weights reduced;
+            reduced.denominator = BigInt(1);
+            for (const auto& weight : fieldWeights(field, sorted)) {
+                reduced.numerators.push_back(field.toBigInt(weight));
+            }
+            return reduced;
+        });
+        std::vector<typename Field::Element> weights;
+        weights.reserve(cached->numerators.size());
+        for (const BigInt& weight : cached->numerators) {
+            weights.push_back(field.fromBigInt(weight));
+        }
+        return weights;
+    }
+    
+    /**
+     * Field Lagrange weights, using the packed 64-bit path when every x fits
+     */
+    template <typename Field>
+    static std::vector<typename Field::Element> fieldWeights(const Field& field, const std::vector<BigInt>& xs) {
+        if (std::all_of(xs.begin(), xs.end(), [](const BigInt& x) { return x.fitsInt64(); })) {
+            std::vector<long long> small;
+            small.reserve(xs.size());
+            for (const BigInt& x : xs) {
+                small.push_back(x.toInt64());
+            }
+            return FieldLagrangeInterpolator<Field>::computeWeights(field, small);
+        }
+        std::vector<typename Field::Element> elements;
+        elements.reserve(xs.size());
+        for (const BigInt& x : xs) {
+            elements.push_back(field.fromBigInt(x));
+        }
+        return FieldLagrangeInterpolator<Field>::computeWeights(field, elements);
+    }
+    
+    static void splitRoots(const Roots& roots, std::vector<BigInt>& xs, std::vector<BigInt>& ys) {
+        xs.clear();
+        ys.clear();
+        xs.reserve(roots.size());
+        ys.reserve(roots.size());
+        for (const Root& root : roots) {
+            xs.push_back(root.x);
+            ys.push_back(root.y);
+        }
+    }
+    
+    /**
+     * Solves the polynomial using system of equations
+     * 
+     * Mathematical approach:
+     * We have 3 equations:
+     * ax₁² + bx₁ + c = y₁  (from root 1)
+     * ax₂² + bx₂ + c = y₂  (from root 2)  
+     * ax₃² + bx₃ + c = y₃  (from root 3)
+     * 
+     * We can solve this system using Cramer's rule to find c
+     */
+    static BigInt solveSystemOfEquations(const Roots& roots) {
+        // Use the first 3 points to solve the system:
+        // ax₁² + bx₁ + c = y₁
+        // ax₂² + bx₂ + c = y₂  
+        // ax₃² + bx₃ + c = y₃
+        
+        const Root& p1 = roots[0];  // First root (x₁, y₁)
+        const Root& p2 = roots[1];  // Second root (x₂, y₂)
+        const Root& p3 = roots[2];  // Third root (x₃, y₃)
+        
+        log() << "Using roots: " << p1.toString() << ", " 
+                  << p2.toString() << ", " << p3.toString() << std::endl;
+        
+        // Convert to BigFloat for precision in calculations
+        BigFloat x1 = static_cast<BigFloat>(p1.x);
+        BigFloat y1 = static_cast<BigFloat>(p1.y);
+        BigFloat x2 = static_cast<BigFloat>(p2.x);
+        BigFloat y2 = static_cast<BigFloat>(p2.y);
+        BigFloat x3 = static_cast<BigFloat>(p3.x);
+        BigFloat y3 = static_cast<BigFloat>(p3.y);
+        
+        // 🔑 MATHEMATICAL STEP: Using Cramer's rule to solve the system
+        // Matrix: [x₁² x₁ 1] [a]   [y₁]
+        //         [x₂² x₂ 1] [b] = [y₂]
+        //         [x₃² x₃ 1] [c]   [y₃]
+        
+        // Calculate the determinant of the coefficient matrix
+        // det = x1²(x2 - x3) + x2²(x3 - x1) + x3²(x1 - x2)
+        // This is the correct formula for the 3x3 determinant
+        BigFloat det = x1 * x1 * x2 + x2 * x2 * x3 + x3 * x3 * x1 
+                     - x1 * x1 * x3 - x2 * x2 * x1 - x3 * x3 * x2;
+        
+        log() << "Determinant: " << det << std::endl;
+        
+        // Check if determinant is zero (system has no unique solution)
+        if (std::abs(det) < 1e-10) {
+            log() << "Warning: Determinant is zero, using fallback method" << std::endl;
+            return solveSimplePolynomial(roots);
+        }
+        
+        // Calculate c using Cramer's rule
+        // Replace the third column with the constants [y₁, y₂, y₃]
+        // detC = x1²*x2*y3 + x2²*x3*y1 + x3²*x1*y2 - x1²*x3*y2 - x2²*x1*y3 - x3²*x2*y1
+        BigFloat detC = x1 * x1 * x2 * y3 + x2 * x2 * x3 * y1 + x3 * x3 * x1 * y2
+                      - x1 * x1 * x3 * y2 - x2 * x2 * x1 * y3 - x3 * x3 * x2 * y1;
+        
+        // c = detC / det
+        BigFloat c = detC / det;
+        
+        log() << "Calculated c (float): " << c << std::endl;
+        
+        // Round to nearest integer
+        BigInt result = BigInt::fromLongDouble(std::round(c));
+        
+        // Verify the solution with other roots
+        verifySolution(roots, c);
+        
+        return result;
+    }
+    
+    /**
+     * Fallback method for solving polynomial with fewer than 3 roots
+     * 
+     * Assumes: f(x) = x² + c (a=1, b=0)
+     * Then: c = y - x²
+     */
+    static BigInt solveSimplePolynomial(const Roots& roots) {
+        // Simple approach: assume a = 1 and b = 0, then c = y - x²
+        const Root& firstRoot = roots[0];
+        BigInt x = firstRoot.x;
+        BigInt y = firstRoot.y;
+        
+        // Calculate x²
+        BigInt xSquared = x * x;
+        
+        // Calculate c = y - x²
+        BigInt c = y - xSquared;
+        
+        log() << "Simple polynomial: c = " << y << " - " << x << "² = " << c << std::endl;
+        
+        // Verify with other roots if possible
+        for (size_t i = 1; i < roots.size(); i++) {
+            const Root& root = roots[i];
+            BigInt expectedY = root.x * root.x + c;
+            if (expectedY != root.y) {
+                log() << "Warning: Root " << root.toString() 
+                         << " doesn't satisfy the equation with c = " << c << std::endl;
+            }
+        }
+        
+        return c;
+    }
+    
+    /**
+     * Verifies the calculated solution with all roots
+     * 
+     * For verification, assumes f(x) = x² + c
+     * Checks if f(x) = y for each root
+     */
+    static void verifySolution(const Roots& roots, BigFloat c) {
+        log() << "Verifying solution..." << std::endl;
+        // Verify the solution with all roots
+        for (const Root& root : roots) {
+            BigFloat x = static_cast<BigFloat>(root.x);
+            BigFloat y = static_cast<BigFloat>(root.y);
+            
+            // For verification, assume a = 1, b = 0: f(x) = x² + c
+            BigFloat expectedY = x * x + c;
+            BigFloat difference = std::abs(y - expectedY);
+            
+            // If difference is more than 1, show a warning
+            if (difference > 1.0) {
+                log() << "Warning: Root " << root.toString() 
+                         << " has difference: " << difference << std::endl;
+            } else {
+                log() << "✓ Root " << root.toString() << " verified (diff: " 
+                         << difference << ")" << std::endl;
+            }
+        }
+    }
+    
+    /**
+     * 🔑 CORE FUNCTION: Decodes a string value from a given base to decimal
+     * 
+     * This is the heart of the solution! It converts encoded strings like:
+     * - "111" (base 2) → 7 (decimal)
+     * - "213" (base 4) → 39 (decimal)
+     * - "a1b2" (base 16) → 41394 (decimal)
+     *
+     * Integer defaults to BigInt; the benchmarks also instantiate it with
+     * long long to compare against the fixed-width path.
+     *
+     * Values that fit in 64 bits (most shares) take a checked native path.
+     * A fixed-width Integer fails fast with std::overflow_error when the
+     * value does not fit; BigInt promotes to the full decoder instead.
+     */
+    template <typename Integer = BigInt>
+    static Integer decodeFromBase(std::string_view value, std::string_view baseStr) {
+        int base = parseInt(baseStr, "base");
+        if (base < 2 || base > 36) {
+            throw std::invalid_argument("Unsupported base: " + std::to_string(base));
+        }
+        
+        if constexpr (std::is_same<Integer, BigInt>::value) {
+            // No 64-bit value has more than 64 digits (base 2)
+            std::uint64_t word = 0;
+            if (value.size() <= 64 && decodeChecked(value, base, word)) {
+                return BigInt(word);
+            }
+            // Vectorized classify/validate/fold, see DigitDecoder
+            return DigitDecoder::decode(value, base);
+        } else {
+            Integer result = 0;
+            if (!decodeChecked(value, base, result)) {
+                throw std::overflow_error("Value \"" + std::string(value) + "\" in base " + std::to_string(base) +
+                                          " overflows a " + std::to_string(sizeof(Integer) * 8) + "-bit integer");
+            }
+            return result;
+        }
+    }
+
+    /**
+     * Horner's rule into a fixed-width integer, with every step checked by
+     * __builtin_mul_overflow/__builtin_add_overflow
+     * Returns false as soon as the value stops fitting (result is then
+     * meaningless, but nothing wrapped or overflowed a signed type); invalid
+     * digits still throw std::invalid_argument.
+     */
+    template <typename Integer>
+    static bool decodeChecked(std::string_view value, int base, Integer& result) {
+        static_assert(std::is_integral<Integer>::value, "decodeChecked needs a built-in integer");
+        // Convert character to digit value
+        auto charToDigit = [](char c) -> int {
+            if (c >= '0' && c <= '9') {
+                return c - '0';
+            } else if (c >= 'a' && c <= 'z') {
+                return c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'Z') {
+                return c - 'A' + 10;
+            }
+            throw std::invalid_argument("Invalid character in base conversion: " + std::string(1, c));
+        };
+
+        // Accumulated locally so it can live in a register across the throws
+        Integer accumulator = 0;
+        
+        // Horner's rule, left to right: accumulator = accumulator * base + digit
+        for (char c : value) {
+            int digitValue = charToDigit(c);
+            
+            if (digitValue >= base) {
+                throw std::invalid_argument("Digit value " + std::to_string(digitValue) + 
+                                          " is invalid for base " + std::to_string(base));
+            }
+            
+            if (__builtin_mul_overflow(accumulator, static_cast<Integer>(base), &accumulator) ||
+                __builtin_add_overflow(accumulator, static_cast<Integer>(digitValue), &accumulator)) {
+                return false;
+            }
+        }
+        result = accumulator;
+        return true;
+    }
+};
+
+/**
+ * Batch driver: solves many test-case files and prints one line per file
+ *
+ *   <file>: c=<constant>
+ *   <file>: error: <message>
+ *
+ * Inputs are file names, glob patterns, or "-" for a manifest of paths on
+ * stdin (one per line). Files are spread over a WorkStealingPool and each
+ * line is printed when its file finishes, so lines follow completion order.
+ */
+class BatchRunner {
+public:
+    /**
+     * Solves every input; returns the number of files that failed
+     */
+    static std::size_t run(const std::vector<std::string>& inputs, const SolverOptions& options,
+                           std::size_t threads) {
+        std::vector<std::string> files = expandInputs(inputs);
+
+        // Files already run in parallel, so each subset vote stays on one thread
+        SolverOptions fileOptions = options;
+        fileOptions.threads = 1;
+        PolynomialSolver::silent = true;
+        std::mutex outputLock;
+        std::size_t failures = 0;
+        WorkStealingPool(threads).forEach(files.size(), [&](std::size_t i) {
+            // Each file's temporaries live in this worker's arena until its line is out
+            static thread_local FileArena arena;
+            FileArena::Scope scope(arena);
+            std::string line = files[i] + ": ";
+            bool failed = false;
+            try {
+                PolynomialSolver::ProcessResult result = PolynomialSolver::processTestCase(files[i], fileOptions);
+                line += "c=" + result.constantC.toString();
+                const auto& numerators = result.coefficients.numerators;
+                if (!numerators.empty()) {
+                    line += " f=(";
+                    for (std::size_t j = 0; j < numerators.size(); ++j) {
+                        line += (j == 0 ? "" : ",") + numerators[j].toString();
+                    }
+                    line += ")";
+                    if (result.coefficients.denominator != BigInt(1)) {
+                        line += "/" + result.coefficients.denominator.toString();
+                    }
+                }
+                if (!result.corrupted.empty()) {
+                    line += " corrupted x=";
+                    for (std::size_t j = 0; j < result.corrupted.size(); ++j) {
+                        line += (j == 0 ? "" : ",") + result.roots[result.corrupted[j]].x.toString();
+                    }
+                }
+            } catch (const std::exception& e) {
+                line += std::string("error: ") + e.what();
+                failed = true;
+            }
+            line += '\n';
+
+            std::lock_guard<std::mutex> guard(outputLock);
+            std::cout << line;
+            failures += failed ? 1 : 0;
+        });
+        PolynomialSolver::silent = false;
+        std::cout.flush();
+        return failures;
+    }
+
+private:
+    static std::vector<std::string> expandInputs(const std::vector<std::string>& inputs) {
+        std::vector<std::string> files;
+        for (const std::string& input : inputs) {
+            if (input == "-") {
+                // Manifest: one path per line, blank lines ignored
+                std::string line;
+                while (std::getline(std::cin, line)) {
+                    if (!line.empty() && line.back() == '\r') {
+                        line.pop_back();
+                    }
+                    if (!line.empty()) {
+                        files.push_back(line);
+                    }
+                }
+            } else if (input.find_first_of("*?[") != std::string::npos) {
+                expandGlob(input, files);
+            } else {
+                files.push_back(input);
+            }
+        }
+        return files;
+    }
+
+    // A pattern that matches nothing is kept as-is and reported as unreadable
+    static void expandGlob(const std::string& pattern, std::vector<std::string>& files) {
+#ifdef POLYSOLVER_HAVE_GLOB
+        glob_t matches;
+        if (::glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+            for (std::size_t i = 0; i < matches.gl_pathc; ++i) {
+                files.emplace_back(matches.gl_pathv[i]);
+            }
+            ::globfree(&matches);
+            return;
+        }
+        ::globfree(&matches);
+#endif
+        files.push_back(pattern);
+    }
+};
+
+/**
+ * Micro-benchmarks for the arithmetic hot paths
+ * Run with --bench; results are printed as ns/op and Mop/s.
+ */
+class SolverBenchmarks {
+public:
+    static void run() {
+        std::cout << "=== Benchmarks ===" << std::endl;
+        benchmarkJsonParse();
+        benchmarkDecode();
+        benchmarkMultiply();
+        benchmarkReconstruction();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Prevents the optimizer from discarding benchmark results
+    template <typename T>
+    static void keep(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    template <typename Body>
+    static void report(const std::string& label, std::size_t operations, Body&& body) {
+        auto start = Clock::now();
+        body();
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        std::cout << "  " << std::left << std::setw(44) << label << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(10) << elapsed / operations
+                  << " ns/op" << std::setw(10) << operations * 1e3 / elapsed << " Mop/s" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    template <typename Body>
+    static void reportThroughput(const std::string& label, std::size_t bytes, int repeats, Body&& body) {
+        auto start = Clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            body();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "  " << std::left << std::setw(44) << label << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(10)
+                  << bytes * static_cast<double>(repeats) / seconds / 1e9 << " GB/s" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    /**
+     * Builds a pretty-printed share file in memory, formatted like the test cases
+     */
+    static std::string makeShareDocument(std::size_t shares, std::size_t valueDigits) {
+        static const char kHex[] = "0123456789abcdef";
+        std::uint64_t state = 42;
+        std::string text = "{\n    \"keys\": {\n        \"n\": " + std::to_string(shares) +
+                           ",\n        \"k\": " + std::to_string(shares / 2 + 1) + "\n    }";
+        for (std::size_t i = 1; i <= shares; ++i) {
+            text += ",\n    \"" + std::to_string(i) + "\": {\n        \"base\": \"16\",\n        \"value\": \"";
+            for (std::size_t d = 0; d < valueDigits; ++d) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                text += kHex[state >> 60];
+            }
+            text += "\"\n    }";
+        }
+        text += "\n}\n";
+        return text;
+    }
+
+    static void benchmarkJsonParse() {
+        const std::size_t shares = 50000;
+        for (std::size_t digits : {16, 64, 1024}) {
+            std::string text = makeShareDocument(shares, digits);
+            std::cout << "JSON parse (" << shares << " shares, " << digits << "-digit values, "
+                      << text.size() / 1024 << " KiB):" << std::endl;
+            reportThroughput("SimpleJsonParser::parse", text.size(), 20, [&] {
+                keep(SimpleJsonParser::parse(text));
+            });
+        }
+
+        // One test case of spilling 1024-digit values decoded into roots, from the heap or a warm arena
+        const std::string text = makeShareDocument(5000, 1024);
+        auto decodeRoots = [&] {
+            PolynomialSolver::Roots roots(FileArena::resource());
+            for (const SimpleJsonParser::ShareEntry& share : SimpleJsonParser::parse(text).shares) {
+                roots.emplace_back(PolynomialSolver::parseIndex(share.index),
+                                   PolynomialSolver::decodeFromBase(share.value, share.base));
+            }
+            keep(roots);
+        };
+        std::cout << "Decode to roots (5000 shares, 1024-digit values):" << std::endl;
+        reportThroughput("heap", text.size(), 20, decodeRoots);
+        FileArena arena;
+        reportThroughput("FileArena, reset per document", text.size(), 20, [&] {
+            FileArena::Scope scope(arena);
+            decodeRoots();
+        });
+    }
+
+    /**
+     * Decodes share values that fit in 63 bits, so both integer types
+     * produce the same answer
+     */
+    static void benchmarkDecode() {
+        const std::vector<std::pair<std::string, std::string>> shares = {
+            {"4", "10"}, {"111", "2"}, {"213", "4"}, {"e1b5e05623d881f", "16"},
+            {"aed7015a346d63", "15"}, {"6aeeb69631c227c", "15"}, {"13444211440455345", "6"},
+        };
+        const std::size_t rounds = 200000;
+        const std::size_t operations = rounds * shares.size();
+
+        std::cout << "Decode (" << shares.size() << " share values x " << rounds << "):" << std::endl;
+        report("decodeFromBase<long long> (checked)", operations, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (const auto& share : shares) {
+                    keep(PolynomialSolver::decodeFromBase<long long>(share.first, share.second));
+                }
+            }
+        });
+        report("decodeFromBase<BigInt>", operations, [&] {
+            for (std::size_t r = 0; r < rounds; ++r) {
+                for (const auto& share : shares) {
+                    keep(PolynomialSolver::decodeFromBase<BigInt>(share.first, share.second));
+                }
+            }
+        });
+
+        // Per-digit cost of each kernel on long values
+        const std::size_t digits = 4096;
+        const std::size_t repeats = 200;
+        for (int base : {10, 16, 36}) {
+            std::string value(digits, '0');
+            std::uint64_t state = 0x2545f4914f6cdd1dULL;
+            for (char& c : value) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                c = "0123456789abcdefghijklmnopqrstuvwxyz"[(state >> 33) % static_cast<std::uint64_t>(base)];
+            }
+            std::cout << "Decode (" << digits << " digits, base " << base << ", per digit):" << std::endl;
+            report("BigInt::fromString (digit at a time)", digits * repeats, [&] {
+                for (std::size_t r = 0; r < repeats; ++r) {
+                    keep(BigInt::fromString(value, base));
+                }
+            });
+            const std::pair<DigitDecoder::Kernel, const char*> kernels[] = {
+                {DigitDecoder::Kernel::Scalar, "DigitDecoder scalar"},
+                {DigitDecoder::Kernel::Sse42, "DigitDecoder SSE4.2"},
+                {DigitDecoder::Kernel::Avx2, "DigitDecoder AVX2"},
+            };
+            for (const auto& kernel : kernels) {
+                if (static_cast<int>(kernel.first) > static_cast<int>(DigitDecoder::bestKernel())) {
+                    continue;
+                }
+                report(kernel.second, digits * repeats, [&] {
+                    for (std::size_t r = 0; r < repeats; ++r) {
+                        keep(DigitDecoder::decode(value, base, kernel.first));
+                    }
+                });
+            }
+        }
+
+        // Every base, share-sized values: run-time base vs the decodeFor<Base> table
+        const std::size_t shareDigits = 96;
+        const std::size_t shareRepeats = 20000;
+        std::cout << "Decode (" << shareDigits << " digits, per digit, best of 5, run-time vs compile-time base):"
+                  << std::endl;
+        for (int base = 2; base <= 36; ++base) {
+            std::string value(shareDigits, '0');
+            std::uint64_t state = 0x9e3779b97f4a7c15ULL + static_cast<std::uint64_t>(base);
+            for (char& c : value) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                c = "0123456789abcdefghijklmnopqrstuvwxyz"[(state >> 33) % static_cast<std::uint64_t>(base)];
+            }
+            const DigitDecoder::Kernel kernel = DigitDecoder::bestKernel();
+            // Short runs are noisy, so each side keeps its fastest of 5
+            auto time = [&](auto&& decode) {
+                double best = std::numeric_limits<double>::max();
+                for (int attempt = 0; attempt < 5; ++attempt) {
+                    auto start = Clock::now();
+                    for (std::size_t r = 0; r < shareRepeats; ++r) {
+                        keep(decode());
+                    }
+                    best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+                }
+                return best / static_cast<double>(shareDigits * shareRepeats);
+            };
+            double runtime = time([&] {
+                return DigitDecoder::decodeFor<DigitDecoder::kRuntimeBase>(value, base, kernel);
+            });
+            double fixed = time([&] { return DigitDecoder::decode(value, base, kernel); });
+            std::cout << "  base " << std::setw(2) << base << std::fixed << std::setprecision(2)
+                      << ": run-time " << std::setw(6) << runtime << " ns/digit, compile-time "
+                      << std::setw(6) << fixed << " ns/digit, speedup " << runtime / fixed << "x" << std::endl;
+            std::cout.unsetf(std::ios::floatfield);
+        }
+
+        // Huge values: recursive split vs plain Horner
+        const std::size_t hugeDigits = 1000000;
+        std::string huge(hugeDigits, '0');
+        std::uint64_t state = 0x853c49e6748fea9bULL;
+        for (char& c : huge) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            c = static_cast<char>('0' + (state >> 33) % 3);
+        }
+        // Power-of-two bases are pure bit placement
+        std::string hex(hugeDigits, '0');
+        for (char& c : hex) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            c = "0123456789abcdef"[state >> 60];
+        }
+        std::cout << "Decode (" << hugeDigits << " digits, base 16):" << std::endl;
+        reportThroughput("DigitDecoder::decode", hex.size(), 20, [&] {
+            keep(DigitDecoder::decode(hex, 16));
+        });
+
+        std::cout << "Decode (" << hugeDigits << " digits, base 3, per digit):" << std::endl;
+        report("DigitDecoder::decode (split)", hugeDigits, [&] {
+            keep(DigitDecoder::decode(huge, 3));
+        });
+        report("DigitDecoder Horner only", hugeDigits, [&] {
+            keep(DigitDecoder::decodeLinear<3>(huge, 3, DigitDecoder::bestKernel()));
+        });
+    }
+
+    static void benchmarkMultiply() {
+        const std::size_t count = 1 << 20;
+        std::vector<long long> native(count);
+        std::vector<BigInt> small(count);
+        std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+        for (std::size_t i = 0; i < count; ++i) {
+            // Keep operands below 2^31 so the long long products cannot overflow
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            native[i] = static_cast<long long>(state >> 33);
+            small[i] = BigInt(native[i]);
+        }
+
+        std::cout << "Multiply (" << count << " products):" << std::endl;
+        report("long long * long long", count, [&] {
+            long long sink = 0;
+            for (std::size_t i = 0; i + 1 < count; ++i) {
+                sink ^= native[i] * native[i + 1];
+            }
+            keep(sink);
+        });
+        report("BigInt * BigInt (1 limb)", count, [&] {
+            for (std::size_t i = 0; i + 1 < count; ++i) {
+                keep(small[i] * small[i + 1]);
+            }
+        });
+
+        // Multi-limb operands for reference: 256-bit (inline), 2048-bit (heap),
+        // 65536-bit (Karatsuba)
+        for (int bits : {256, 2048, 65536}) {
+            BigInt a = (BigInt(1) << static_cast<std::size_t>(bits)) - BigInt(189);
+            BigInt b = (BigInt(1) << static_cast<std::size_t>(bits - 1)) + BigInt(12345);
+            const std::size_t products = bits == 256 ? count : bits == 2048 ? count / 64 : count / 4096;
+            report("BigInt * BigInt (" + std::to_string(bits) + "-bit)", products, [&] {
+                for (std::size_t i = 0; i < products; ++i) {
+                    keep(a * b);
+                }
+            });
+        }
+    }
+
+    /**
+     * One k = 1000 reconstruction at x = 1..k with 256-bit y-values, exact
+     * over the integers and modulo secp256k1's group order
+     */
+    static void benchmarkReconstruction() {
+        const std::size_t k = 1000;
+        std::vector<BigInt> xs, ys;
+        std::uint64_t state = 12345;
+        for (std::size_t i = 1; i <= k; ++i) {
+            xs.push_back(BigInt(i));
+            BigInt y;
+            for (int limb = 0; limb < 4; ++limb) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                y = (y << 64) + BigInt(state);
+            }
+            ys.push_back(y);
+        }
+
+        std::cout << "Reconstruction (k = " << k << "):" << std::endl;
+        report("exact integer Lagrange", 1, [&] {
+            LagrangeInterpolator::Weights weights = LagrangeInterpolator::computeWeights(xs);
+            keep(LagrangeInterpolator::weightedSum(weights, ys));
+        });
+        LagrangeWeightsCache cache;
+        auto computeExact = [](const std::vector<BigInt>& sorted) { return LagrangeInterpolator::computeWeights(sorted); };
+        keep(cache.get(BigInt(), xs, computeExact));
+        report("exact Lagrange, cached weights", 1, [&] {
+            keep(LagrangeInterpolator::weightedSum(*cache.get(BigInt(), xs, computeExact), ys));
+        });
+        report("online exact Lagrange, k adds", 1, [&] {
+            OnlineLagrangeInterpolator online;
+            for (std::size_t i = 0; i < k; ++i) {
+                online.add(xs[i], ys[i]);
+            }
+            keep(LagrangeInterpolator::weightedSum(online.weights(), ys));
+        });
+        const BigInt prime = SolverOptions::parsePrime("secp256k1");
+        withMontgomeryField(prime, [&](const auto& field) {
+            using Field = std::decay_t<decltype(field)>;
+            std::vector<long long> fx;
+            std::vector<typename Field::Element> fy;
+            for (std::size_t i = 0; i < k; ++i) {
+                fx.push_back(static_cast<long long>(i + 1));
+                fy.push_back(field.fromBigInt(ys[i]));
+            }
+            report("GF(p) Lagrange, secp256k1 order", 1, [&] {
+                using Interpolator = FieldLagrangeInterpolator<Field>;
+                keep(Interpolator::dot(field, Interpolator::computeWeights(field, fx), fy));
+            });
+            report("online GF(p) Lagrange, k adds", 1, [&] {
+                OnlineFieldLagrangeInterpolator<Field> online(field);
+                for (std::size_t i = 0; i < k; ++i) {
+                    online.add(field.fromUint64(i + 1), fy[i]);
+                }
+                keep(online.secret());
+            });
+
+            // Error correction is O(n³): n = 100 shares, k = 60, 20 of them corrupted
+            const std::size_t shares = 100, threshold = 60, errors = 20;
+            std::vector<typename Field::Element> coefficients(fy.begin(), fy.begin() + threshold);
+            std::vector<typename Field::Element> bx, by;
+            for (std::size_t i = 0; i < shares; ++i) {
+                bx.push_back(field.fromUint64(i + 1));
+                by.push_back(BerlekampWelchDecoder<Field>::evaluate(field, coefficients, bx.back()));
+                if (i % (shares / errors) == 0) {
+                    by.back() = field.add(by.back(), field.one());
+                }
+            }
+            std::cout << "Berlekamp-Welch (n = " << shares << ", k = " << threshold << ", "
+                      << errors << " corrupted):" << std::endl;
+            report("GF(p) decode, secp256k1 order", 1, [&] {
+                keep(BerlekampWelchDecoder<Field>::decode(field, bx, by, threshold));
+            });
+
+            // Subset vote: 6 of 20 shares off, so no early majority and all C(20, 10) subsets run
+            using Vote = SubsetVote<Field>;
+            const std::size_t voters = 20, quorum = 10, outliers = 6;
+            std::vector<typename Field::Element> quorumCoefficients(fy.begin(), fy.begin() + quorum);
+            std::vector<typename Field::Element> vx, vy;
+            for (std::size_t i = 0; i < voters; ++i) {
+                vx.push_back(field.fromUint64(i + 1));
+                vy.push_back(BerlekampWelchDecoder<Field>::evaluate(field, quorumCoefficients, vx.back()));
+                if (i < 2 * outliers && i % 2 == 0) {
+                    vy.back() = field.add(vy.back(), field.one());
+                }
+            }
+            const typename Vote::Tables tables(field, vx, vy, quorum);
+            const std::uint64_t subsets = tables.binomial(voters, quorum);
+            std::cout << "Subset vote (n = " << voters << ", k = " << quorum << ", " << outliers
+                      << " outliers, per subset):" << std::endl;
+            report("interpolate every subset afresh", subsets, [&] {
+                for (std::uint64_t rank = 0; rank < subsets; ++rank) {
+                    keep(typename Vote::Walker(tables, rank).secret());
+                }
+            });
+            report("revolving-door walk", subsets, [&] {
+                typename Vote::Walker walker(tables, 0);
+                keep(walker.secret());
+                for (std::uint64_t rank = 1; rank < subsets; ++rank) {
+                    walker.next();
+                    keep(walker.secret());
+                }
+            });
+            report("full vote, 1 thread", subsets, [&] {
+                keep(Vote::run(field, vx, vy, quorum, 1).secret);
+            });
+            return 0;
+        });
+
+        // Gao decoding over the NTT prime 2^64 - 2^32 + 1, a quarter of the shares corrupted
+        const MontgomeryField<1> ntt(SolverOptions::parsePrime("goldilocks"));
+        std::cout << "Reed-Solomon decode modulo 2^64 - 2^32 + 1 (k = n/2, n/4 corrupted):" << std::endl;
+        for (std::size_t shares : {128, 1024, 16384}) {
+            const std::size_t threshold = shares / 2;
+            std::vector<MontgomeryField<1>::Element> coefficients, gx, gy;
+            for (std::size_t i = 0; i < threshold; ++i) {
+                coefficients.push_back(ntt.fromUint64(i * 0x9e3779b97f4a7c15ULL));
+            }
+            for (std::size_t i = 0; i < shares; ++i) {
+                gx.push_back(ntt.fromUint64(i + 1));
+                gy.push_back(BerlekampWelchDecoder<MontgomeryField<1>>::evaluate(ntt, coefficients, gx.back()));
+                if (i % 4 == 0) {
+                    gy.back() = ntt.add(gy.back(), ntt.one());
+                }
+            }
+            if (shares <= 128) {
+                report("Berlekamp-Welch, n = " + std::to_string(shares), 1, [&] {
+                    keep(BerlekampWelchDecoder<MontgomeryField<1>>::decode(ntt, gx, gy, threshold));
+                });
+            }
+            report("Gao, n = " + std::to_string(shares), 1, [&] {
+                keep(GaoDecoder<MontgomeryField<1>>::decode(ntt, gx, gy, threshold));
+            });
+        }
+
+        // Many secrets over one x-set: per-secret solves against the batch kernel
+        const std::size_t batchK = 16, secrets = std::size_t(1) << 16;
+        std::vector<BigInt> batchXs(xs.begin(), xs.begin() + static_cast<long>(batchK)), batchYs;
+        std::uint64_t batchState = 99;
+        for (std::size_t i = 0; i < batchK * secrets; ++i) {
+            batchState = batchState * 6364136223846793005ULL + 1442695040888963407ULL;
+            batchYs.push_back(BigInt(batchState >> 34));
+        }
+        std::cout << "Batch reconstruction (k = " << batchK << ", " << secrets << " secrets, per secret):" << std::endl;
+        PolynomialSolver::silent = true;
+        SolverOptions batchOptions;
+        batchOptions.weightsCache = std::make_shared<LagrangeWeightsCache>();
+        report("exact, one cached solve per secret", 4096, [&] {
+            for (std::size_t s = 0; s < 4096; ++s) {
+                PolynomialSolver::Roots roots;
+                for (std::size_t i = 0; i < batchK; ++i) {
+                    roots.emplace_back(batchXs[i], batchYs[i * secrets + s]);
+                }
+                keep(PolynomialSolver::solveExactLagrange(roots, batchOptions.weightsCache.get()));
+            }
+        });
+        report("exact batch", secrets, [&] {
+            keep(PolynomialSolver::reconstructBatch(batchXs, batchYs, secrets, batchOptions));
+        });
+        PolynomialSolver::silent = false;
+        batchOptions.strategy = SolverStrategy::PrimeField;
+        for (const char* prime : {"998244353", "goldilocks", "secp256k1"}) {
+            batchOptions.prime = SolverOptions::parsePrime(prime);
+            report(std::string("batch mod ") + prime, secrets, [&] {
+                keep(PolynomialSolver::reconstructBatch(batchXs, batchYs, secrets, batchOptions));
+            });
+        }
+        const MontgomeryField32 batchField(998244353);
+        std::vector<MontgomeryField32::Element> smallWeights, smallYs;
+        for (std::size_t i = 0; i < batchK; ++i) {
+            smallWeights.push_back(batchField.fromUint64(i * 0x9e3779b9u));
+        }
+        for (const BigInt& y : batchYs) {
+            smallYs.push_back(batchField.fromBigInt(y));
+        }
+        std::vector<MontgomeryField32::Element> smallSums(secrets);
+        report("kernel only mod 998244353", secrets, [&] {
+            BatchLagrangeKernel<MontgomeryField32>::run(batchField, smallWeights, smallYs.data(), secrets, smallSums.data());
+            keep(smallSums);
+        });
+
+        // Σ λ_i · y_i: a Montgomery product and modular add per term, or one reduction at the end
+        const std::size_t terms = 4096;
+        std::cout << "Modular dot product (" << terms << " terms, per term):" << std::endl;
+        auto benchmarkDot = [&](const auto& field, const std::string& name) {
+            std::vector<typename std::decay_t<decltype(field)>::Element> a, b;
+            for (std::size_t i = 0; i < terms; ++i) {
+                a.push_back(field.fromUint64(i * 0x9e3779b97f4a7c15ULL));
+                b.push_back(field.fromUint64(i * 0xbf58476d1ce4e5b9ULL + 1));
+            }
+            report("mul/add mod " + name, terms * 100, [&] {
+                for (int r = 0; r < 100; ++r) {
+                    auto sum = field.zero();
+                    for (std::size_t i = 0; i < terms; ++i) {
+                        sum = field.add(sum, field.mul(a[i], b[i]));
+                    }
+                    keep(sum);
+                }
+            });
+            report("lazy dot mod " + name, terms * 100, [&] {
+                for (int r = 0; r < 100; ++r) {
+                    keep(field.dot(a.data(), b.data(), terms));
+                }
+            });
+        };
+        benchmarkDot(MontgomeryField<1>(SolverOptions::parsePrime("goldilocks")), "2^64 - 2^32 + 1");
+        benchmarkDot(MontgomeryField32(998244353), "998244353");
+
+        // Every coefficient through k = n/2 roots and every root checked, against c plus a check per extra root
+        std::cout << "Whole polynomial (n = 2k, all coefficients, every root checked):" << std::endl;
+        PolynomialSolver::silent = true;
+        for (const bool exact : {true, false}) {
+            const std::size_t shares = exact ? 512 : 4096, threshold = shares / 2;
+            PolynomialSolver::Roots roots;
+            for (std::size_t i = 0; i < shares; ++i) {
+                roots.emplace_back(BigInt(i + 1), ys[i % k]);
+            }
+            SolverOptions fitOptions;
+            fitOptions.fullPolynomial = true;
+            if (!exact) {
+                fitOptions.strategy = SolverStrategy::PrimeField;
+                fitOptions.prime = SolverOptions::parsePrime("goldilocks");
+            }
+            const std::string suffix = ", k = " + std::to_string(threshold);
+            report((exact ? "exact tree" : "tree mod 2^64 - 2^32 + 1") + suffix, 1, [&] {
+                std::vector<std::size_t> off;
+                keep(PolynomialSolver::solveFullPolynomial(roots, threshold, fitOptions, &off, nullptr));
+            });
+            if (exact) {
+                PolynomialSolver::Roots used(roots.begin(), roots.begin() + static_cast<long>(threshold));
+                PolynomialSolver::Roots extra(roots.begin() + static_cast<long>(threshold), roots.end());
+                report("exact c + check per extra root" + suffix, 1, [&] {
+                    keep(PolynomialSolver::solveExactLagrange(used));
+                    PolynomialSolver::verifyExtraRoots(used, extra);
+                });
+            }
+        }
+        PolynomialSolver::silent = false;
+
+        // One product of two degree-2^15 polynomials, per output coefficient
+        const std::size_t length = std::size_t(1) << 15;
+        std::cout << "Polynomial product (" << length << " x " << length << " coefficients, per coefficient):"
+                  << std::endl;
+        const MontgomeryField32 small(998244353);
+        const NumberTheoreticTransform<MontgomeryField32> smallTransform(small);
+        const NumberTheoreticTransform<MontgomeryField<1>> wideTransform(ntt);
+        std::vector<std::uint32_t> sp, sq;
+        std::vector<MontgomeryField<1>::Element> wp, wq;
+        std::vector<BigInt> bp, bq;
+        for (std::size_t i = 0; i < length; ++i) {
+            sp.push_back(small.fromUint64(i * 31 + 7));
+            sq.push_back(small.fromUint64(i * 17 + 3));
+            wp.push_back(ntt.fromUint64(i * 31 + 7));
+            wq.push_back(ntt.fromUint64(i * 17 + 3));
+            bp.push_back((BigInt(static_cast<long long>(i) + 1) << 200) - BigInt(static_cast<long long>(i)));
+            bq.push_back((BigInt(static_cast<long long>(i) + 5) << 180) + BigInt(static_cast<long long>(i)));
+        }
+        report("NTT mod 998244353 (32-bit Montgomery)", 2 * length, [&] {
+            keep(smallTransform.multiply(sp, sq));
+        });
+        report("NTT mod 2^64 - 2^32 + 1", 2 * length, [&] {
+            keep(wideTransform.multiply(wp, wq));
+        });
+        CrtPolynomialMultiplier crt;
+        report("exact, ~200-bit coefficients (CRT)", 2 * length, [&] {
+            keep(crt.multiply(bp, bq));
+        });
+    }
+};
+
+/**
+ * Correctness checks for the fast arithmetic, against plain reference
+ * implementations
+ * Run with --self-check; prints one line per failed case and exits
+ * non-zero when any case fails.
+ */
+class SolverSelfChecks {
+public:
+    // Returns the number of failed cases
+    static std::size_t run() {
+        std::cout << "=== Self checks ===" << std::endl;
+        std::size_t failures = 0;
+        failures += checkTransforms();
+        failures += checkDecoding();
+        failures += checkArena();
+        std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed")
+                  << std::endl;
+        return failures;
+    }
+
+private:
+    // Deterministic pseudo-random words
+    struct Random {
+        std::uint64_t state;
+        std::uint64_t next() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return state ^ (state >> 29);
+        }
+    };
+
+    static std::size_t report(bool ok, const std::string& what) {
+        if (!ok) {
+            std::cout << "  FAILED: " << what << std::endl;
+        }
+        return ok ? 0 : 1;
+    }
+
+    template <typename Field>
+    static std::vector<typename Field::Element> schoolbook(const Field& field,
+                                                           const std::vector<typename Field::Element>& p,
+                                                           const std::vector<typename Field::Element>& q) {
+        std::vector<typename Field::Element> product(p.size() + q.size() - 1, field.zero());
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            for (std::size_t j = 0; j < q.size(); ++j) {
+                product[i + j] = field.add(product[i + j], field.mul(p[i], q[j]));
+            }
+        }
+        return product;
+    }
+
+    template <typename Element>
+    static void trim(std::vector<Element>& p, const Element& zero) {
+        while (!p.empty() && p.back() == zero) {
+            p.pop_back();
+        }
+    }
+
+    /**
+     * NTT products against schoolbook at lengths on both sides of every
+     * transform size from 2 to 4096, so odd and even level counts (the
+     * radix-2 tail) and the AVX2 butterflies (quarter >= 8) all run, and
+     * CRT products of signed integers of several widths
+     */
+    static std::size_t checkTransforms() {
+        std::size_t failures = 0;
+        Random random{2020};
+        const std::vector<std::size_t> lengths = {1, 2, 3, 5, 8, 9, 16, 17, 31, 33, 64, 65, 127, 129,
+                                                  255, 257, 511, 513, 1024, 1025, 2047};
+        auto checkField = [&](const auto& field, const std::string& name) {
+            using Field = std::decay_t<decltype(field)>;
+            const NumberTheoreticTransform<Field> transform(field);
+            for (std::size_t a : lengths) {
+                for (std::size_t b : {std::size_t(1), a, a + 3}) {
+                    std::vector<typename Field::Element> p, q;
+                    for (std::size_t i = 0; i < a; ++i) {
+                        p.push_back(field.fromUint64(random.next()));
+                    }
+                    for (std::size_t i = 0; i < b; ++i) {
+                        q.push_back(field.fromUint64(random.next()));
+                    }
+                    auto fast = transform.multiply(p, q);
+                    auto slow = schoolbook(field, p, q);
+                    trim(fast, field.zero());
+                    trim(slow, field.zero());
+                    failures += report(fast == slow, "NTT product mod " + name + ", " + std::to_string(a) +
+                                                         " x " + std::to_string(b));
+                }
+            }
+            // forward then inverse is the identity
+            for (std::size_t n = 1; n <= 4096; n *= 2) {
+                std::vector<typename Field::Element> values(n);
+                for (auto& value : values) {
+                    value = field.fromUint64(random.next());
+                }
+                auto round = values;
+                transform.forward(round);
+                transform.inverse(round);
+                failures += report(round == values, "NTT round trip mod " + name + ", n = " + std::to_string(n));
+            }
+        };
+        checkField(MontgomeryField32(998244353), "998244353");
+        checkField(MontgomeryField<1>(SolverOptions::parsePrime("goldilocks")), "2^64 - 2^32 + 1");
+
+        // Signed coefficients from 1 to 300 bits, so Garner's sign recovery and the prime count both vary
+        const CrtPolynomialMultiplier crt;
+        const IntegerRing ring;
+        for (std::size_t bits : {1, 20, 63, 64, 130, 300}) {
+            for (std::size_t a : {1, 7, 40, 300}) {
+                std::vector<BigInt> p, q;
+                for (std::size_t i = 0; i < 2 * a; ++i) {
+                    BigInt value;
+                    for (std::size_t limb = 0; limb * 64 < bits; ++limb) {
+                        value = (value << 64) + BigInt(random.next());
+                    }
+                    value = value % (BigInt(1) << bits);
+                    (i < a ? p : q).push_back(random.next() % 3 == 0 ? -value : value);
+                }
+                auto fast = crt.multiply(p, q);
+                auto slow = schoolbook(ring, p, q);
+                trim(fast, BigInt());
+                trim(slow, BigInt());
+                failures += report(fast == slow, "CRT product, " + std::to_string(bits) + "-bit coefficients, " +
+                                                     std::to_string(a) + " x " + std::to_string(a));
+            }
+        }
+        return failures;
+    }
+
+    /**
+     * Fast polynomial arithmetic over the goldilocks field against the
+     * definitions, and Gao decoding of planted codewords with 0, some and
+     * the maximum ⌊(n - k) / 2⌋ corrupted shares
+     */
+    static std::size_t checkDecoding() {
+        using Field = MontgomeryField<1>;
+        using Element = Field::Element;
+        std::size_t failures = 0;
+        Random random{2019};
+        const Field field(SolverOptions::parsePrime("goldilocks"));
+        const PolynomialArithmetic<Field> arithmetic(field);
+        auto randomPolynomial = [&](std::size_t size) {
+            std::vector<Element> p(size);
+            for (auto& coefficient : p) {
+                coefficient = field.fromUint64(random.next());
+            }
+            return p;
+        };
+        auto distinctPoints = [&](std::size_t n) {
+            std::vector<Element> xs;
+            for (std::size_t i = 1; i <= n; ++i) {
+                xs.push_back(field.fromUint64(i * 7919 + 11));
+            }
+            return xs;
+        };
+        auto horner = [&](const std::vector<Element>& p, const Element& x) {
+            Element value = field.zero();
+            for (std::size_t i = p.size(); i-- > 0;) {
+                value = field.add(field.mul(value, x), p[i]);
+            }
+            return value;
+        };
+
+        for (std::size_t n : {1, 2, 5, 33, 128, 300, 1000}) {
+            const auto p = randomPolynomial(n + 17);
+            const auto d = randomPolynomial(n);
+            const auto [quotient, remainder] = arithmetic.divmod(p, d);
+            failures += report(arithmetic.add(arithmetic.multiply(quotient, d), remainder) == p &&
+                                   PolynomialArithmetic<Field>::degree(remainder) <
+                                       PolynomialArithmetic<Field>::degree(d),
+                               "divmod identity, divisor of size " + std::to_string(n));
+
+            const auto xs = distinctPoints(n);
+            const auto tree = arithmetic.subproductTree(xs);
+            const auto values = arithmetic.evaluate(p, tree, xs);
+            bool agrees = true;
+            for (std::size_t i = 0; i < n; ++i) {
+                agrees = agrees && values[i] == horner(p, xs[i]);
+            }
+            failures += report(agrees, "multipoint evaluation at " + std::to_string(n) + " points");
+
+            const auto f = randomPolynomial(n);
+            failures += report(arithmetic.interpolate(tree, xs, arithmetic.evaluate(f, tree, xs)) == f,
+                               "interpolation through " + std::to_string(n) + " points");
+        }
+
+        const std::vector<std::pair<std::size_t, std::size_t>> shapes = {
+            {1, 1}, {8, 4}, {9, 4}, {33, 16}, {128, 64}, {300, 101}, {1024, 512}};
+        for (const auto& [n, k] : shapes) {
+            const std::size_t maximum = (n - k) / 2;
+            for (std::size_t errors : {std::size_t(0), std::min<std::size_t>(1, maximum), maximum}) {
+                const auto coefficients = randomPolynomial(k);
+                const auto xs = distinctPoints(n);
+                std::vector<Element> ys;
+                for (const auto& x : xs) {
+                    ys.push_back(horner(coefficients, x));
+                }
+                // Corrupt an evenly spread set of positions, each by a nonzero offset
+                std::vector<std::size_t> corrupted;
+                for (std::size_t i = 0; i < errors; ++i) {
+                    corrupted.push_back(i * n / errors);
+                    ys[corrupted.back()] = field.add(ys[corrupted.back()], field.fromUint64(1 + random.next() % 1000));
+                }
+                const std::string what = "Gao decode, n = " + std::to_string(n) + ", k = " + std::to_string(k) +
+                                         ", " + std::to_string(errors) + " errors";
+                try {
+                    const auto result = GaoDecoder<Field>::decode(field, xs, ys, k);
+                    failures += report(result.coefficients == coefficients && result.corrupted == corrupted, what);
+                } catch (const std::exception& e) {
+                    failures += report(false, what + " threw: " + e.what());
+                }
+            }
+        }
+        return failures;
+    }
+
+    /**
+     * A file solved repeatedly in one FileArena, started too small for it:
+     * the first pass overflows to the heap, and once reset() has grown the
+     * block to the high-water mark, later passes must not
+     */
+    static std::size_t checkArena() {
+        std::size_t failures = 0;
+        Random random{2025};
+        const std::size_t n = 24, k = 16;
+        std::vector<BigInt> coefficients;
+        for (std::size_t i = 0; i < k; ++i) {
+            BigInt value;
+            for (int limb = 0; limb < 8; ++limb) {
+                value = (value << 64) + BigInt(random.next());
+            }
+            coefficients.push_back(value);
+        }
+        std::string text = "{\n    \"keys\": {\"n\": " + std::to_string(n) + ", \"k\": " + std::to_string(k) + "}";
+        for (std::size_t x = 1; x <= n; ++x) {
+            BigInt y;
+            for (std::size_t i = k; i-- > 0;) {
+                y = y * BigInt(static_cast<long long>(x)) + coefficients[i];
+            }
+            text += ",\n    \"" + std::to_string(x) + "\": {\"base\": \"10\", \"value\": \"" + y.toString() + "\"}";
+        }
+        text += "\n}\n";
+        const char* directory = std::getenv("TMPDIR");
+        const std::string path = std::string(directory != nullptr ? directory : "/tmp") + "/polysolver_self_check.json";
+        std::ofstream(path, std::ios::trunc) << text;
+
+        PolynomialSolver::silent = true;
+        FileArena arena(256);
+        for (int pass = 0; pass < 8; ++pass) {
+            FileArena::Scope scope(arena);
+            try {
+                const auto result = PolynomialSolver::processTestCase(path);
+                failures += report(result.constantC == coefficients[0],
+                                   "arena pass " + std::to_string(pass) + " constant");
+            } catch (const std::exception& e) {
+                failures += report(false, "arena pass " + std::to_string(pass) + " threw: " + e.what());
+            }
+            if (pass == 0) {
+                failures += report(arena.overflowCount() > 0, "arena pass 0 fit a 256-byte block");
+            } else if (pass >= 3) {
+                failures += report(arena.overflowCount() == 0, "arena pass " + std::to_string(pass) + " overflowed " +
+                                                                   std::to_string(arena.overflowCount()) + " times");
+            }
+        }
+        PolynomialSolver::silent = false;
+        std::remove(path.c_str());
+        return failures;
+    }
+};
+
+// Main function
+int main(int argc, char* argv[]) {
+    SolverOptions options;
+    std::string streamInput;
+    std::string weightsCachePath;
+    const char* primeText = nullptr;
+    std::vector<std::string> batchInputs;
+    std::size_t jobs = WorkStealingPool::hardwareThreads();
+    bool bench = false;
+    bool selfCheck = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench") {
+            bench = true;
+        } else if (arg == "--self-check") {
+            selfCheck = true;
+        } else if (arg == "--stream" && i + 1 < argc) {
+            // Read one test case incrementally from a file or "-" (stdin)
+            streamInput = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--quiet") {
+            PolynomialSolver::verbose = false;
+        } else if (arg == "--correct-errors") {
+            options.correctErrors = true;
+        } else if (arg == "--vote") {
+            options.voteSubsets = true;
+        } else if (arg == "--coefficients") {
+            options.fullPolynomial = true;
+        } else if (arg == "--weights-cache" && i + 1 < argc) {
+            // Keep Lagrange weights in this file between runs
+            weightsCachePath = argv[++i];
+        } else if (arg == "--cramer") {
+            options.strategy = SolverStrategy::Cramer;
+        } else if (arg == "--gao") {
+            options.strategy = SolverStrategy::GaoDecoding;
+        } else if (arg == "--prime" && i + 1 < argc) {
+            // Reconstruct modulo a prime: decimal, 0x-hex, secp256k1, mersenne127 or goldilocks
+            options.strategy = SolverStrategy::PrimeField;
+            primeText = argv[++i];
+        } else if (arg == "-" || arg.compare(0, 2, "--") != 0) {
+            // Test-case files, globs, or "-" for a list of paths on stdin
+            batchInputs.push_back(arg);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--bench] [--self-check] [--quiet] [--cramer] [--gao] [--prime <p>] [--correct-errors] [--vote]"
+                      << " [--coefficients] [--weights-cache <file>]"
+                      << " [--stream <file|->] [--jobs <n>] [<file|glob|->...]" << std::endl;
+            return 1;
+        }
+    }
+
+    options.threads = jobs;
+    options.weightsCache = std::make_shared<LagrangeWeightsCache>();
+    try {
+        if (primeText != nullptr) {
+            options.prime = SolverOptions::parsePrime(primeText);
+        }
+        if (!weightsCachePath.empty()) {
+            options.weightsCache->load(weightsCachePath);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    auto saveWeights = [&]() {
+        if (weightsCachePath.empty()) {
+            return true;
+        }
+        try {
+            options.weightsCache->save(weightsCachePath);
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return false;
+        }
+    };
+
+    // Batch output is one result line per file and nothing else
+    if (!batchInputs.empty()) {
+        const bool solved = BatchRunner::run(batchInputs, options, jobs) == 0;
+        return saveWeights() && solved ? 0 : 1;
+    }
+
+    std::cout << "Polynomial Solver C++ Version" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    
+    if (bench) {
+        SolverBenchmarks::run();
+        return 0;
+    }
+
+    if (selfCheck) {
+        return SolverSelfChecks::run() == 0 ? 0 : 1;
+    }
+
+    if (!streamInput.empty()) {
+        try {
+            BigInt c = PolynomialSolver::streamTestCase(streamInput, options);
+            std::cout << "Constant c: " << c << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    PolynomialSolver::runTests(options);
+    
+    return saveWeights() ? 0 : 1;
+}